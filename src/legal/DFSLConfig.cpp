@@ -1,7 +1,11 @@
 #include "DFSLConfig.hpp"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <type_traits>
 
 namespace DFSLC {
 
@@ -32,6 +36,8 @@ void ConfigList::initAllConfigs(){
     newConfig<int>   ("OutputLevel"             , ConfigType::INT   ,   2                , "0 : Errors\n1 : Warnings\n2 : Standard info\n3 : Verbose info");
 
     newConfig<double>("MaxCostCutoff"           , ConfigType::DOUBLE,   5000.0           , "max cost cutoff for dfs"             );
+    newConfig<int>   ("PathSearchEngine"        , ConfigType::INT   ,   0                , "0 : exhaustive dfs\n1 : best-first search, stops at the first whitespace reached, needs non-negative edge costs");
+    newConfig<int>   ("PathSearchThreads"       , ConfigType::INT   ,   1                , "threads of the exhaustive dfs, 0 : one per hardware thread");
 
     newConfig<double>("OBAreaWeight"            , ConfigType::DOUBLE,   750.0            , ""                                    );
     newConfig<double>("OBUtilWeight"            , ConfigType::DOUBLE,   1000.0           , ""                                    );
@@ -53,6 +59,9 @@ void ConfigList::initAllConfigs(){
     newConfig<bool>  ("ExactAreaMigration"        , ConfigType::BOOL,     false             , "Controls if exact area migration"    ); // see note 1
     newConfig<bool>  ("MigrationAreaLimit"        , ConfigType::BOOL,     false            , ""                                    );
     newConfig<double>("MaxMigrationAreaSingleIter", ConfigType::DOUBLE, 0.01             , ""                                    );
+
+    newConfig<bool>  ("UseTilePlane"              , ConfigType::BOOL,     false            , "Run plane queries of graph construction on the SoA tile mirror");
+    newConfig<bool>  ("IncrementalGraph"          , ConfigType::BOOL,     false            , "Refresh only the part of the graph touched by a migration instead of rebuilding it.\nNode numbering differs from full rebuilds, so ties between equal cost paths may be broken differently");
 }
 
 
@@ -178,6 +187,79 @@ Config& ConfigList::getConfig(std::string configName){
     }
 }
 
+CompiledConfig ConfigList::compile(){
+    CompiledConfig compiled;
+    auto read = [this](const char* configName, ConfigType type, auto& field){
+        Config& config = getConfig(configName);
+        if (config.getType() != type){
+            std::cerr << "Config \"" << configName << "\" has the wrong type" << std::endl;
+            throw std::invalid_argument(configName);
+        }
+        field = config.getValue<std::remove_reference_t<decltype(field)>>();
+    };
+    read("OutputLevel", ConfigType::INT, compiled.outputLevel);
+    read("MaxCostCutoff", ConfigType::DOUBLE, compiled.maxCostCutoff);
+    read("PathSearchEngine", ConfigType::INT, compiled.pathSearchEngine);
+    read("PathSearchThreads", ConfigType::INT, compiled.pathSearchThreads);
+    read("OBAreaWeight", ConfigType::DOUBLE, compiled.obAreaWeight);
+    read("OBUtilWeight", ConfigType::DOUBLE, compiled.obUtilWeight);
+    read("OBAspWeight", ConfigType::DOUBLE, compiled.obAspWeight);
+    read("OBUtilPosRein", ConfigType::DOUBLE, compiled.obUtilPosRein);
+    read("BWUtilWeight", ConfigType::DOUBLE, compiled.bwUtilWeight);
+    read("BWUtilPosRein", ConfigType::DOUBLE, compiled.bwUtilPosRein);
+    read("BWAspWeight", ConfigType::DOUBLE, compiled.bwAspWeight);
+    read("BBAreaWeight", ConfigType::DOUBLE, compiled.bbAreaWeight);
+    read("BBFromUtilWeight", ConfigType::DOUBLE, compiled.bbFromUtilWeight);
+    read("BBFromUtilPosRein", ConfigType::DOUBLE, compiled.bbFromUtilPosRein);
+    read("BBToUtilWeight", ConfigType::DOUBLE, compiled.bbToUtilWeight);
+    read("BBToUtilPosRein", ConfigType::DOUBLE, compiled.bbToUtilPosRein);
+    read("BBAspWeight", ConfigType::DOUBLE, compiled.bbAspWeight);
+    read("BBFlatCost", ConfigType::DOUBLE, compiled.bbFlatCost);
+    read("WWFlatCost", ConfigType::DOUBLE, compiled.wwFlatCost);
+    read("ExactAreaMigration", ConfigType::BOOL, compiled.exactAreaMigration);
+    read("MigrationAreaLimit", ConfigType::BOOL, compiled.migrationAreaLimit);
+    read("MaxMigrationAreaSingleIter", ConfigType::DOUBLE, compiled.maxMigrationAreaSingleIter);
+    read("UseTilePlane", ConfigType::BOOL, compiled.useTilePlane);
+    read("IncrementalGraph", ConfigType::BOOL, compiled.incrementalGraph);
+
+    if (compiled.outputLevel < 0 || compiled.outputLevel > 3){
+        std::cerr << "OutputLevel must be within 0 ~ 3" << std::endl;
+        throw std::invalid_argument("OutputLevel");
+    }
+    if (compiled.pathSearchEngine != 0 && compiled.pathSearchEngine != 1){
+        std::cerr << "PathSearchEngine must be 0 or 1" << std::endl;
+        throw std::invalid_argument("PathSearchEngine");
+    }
+    if (compiled.pathSearchThreads < 0){
+        std::cerr << "PathSearchThreads must not be negative" << std::endl;
+        throw std::invalid_argument("PathSearchThreads");
+    }
+    // best-first search settles every node once, which is only exact if no edge cost is negative
+    if (compiled.pathSearchEngine == 1 && (compiled.bbEdgeCostFloor() < 0.0 || compiled.bwEdgeCostFloor() < 0.0)){
+        std::cerr << "PathSearchEngine = 1 needs weights that keep every edge cost non-negative, check the *PosRein and BBFlatCost configs" << std::endl;
+        throw std::invalid_argument("PathSearchEngine");
+    }
+    return compiled;
+}
+
+// util terms stay within [min(0, weight, posRein), max(...)], area and aspect terms are >= 0 for positive weights
+static double unboundedFloor(double weight){
+    return weight >= 0.0 ? 0.0 : -std::numeric_limits<double>::infinity();
+}
+
+static double utilFloor(double weight, double posRein){
+    return std::min(0.0, std::min(weight, posRein));
+}
+
+double CompiledConfig::bbEdgeCostFloor() const {
+    return bbFlatCost + unboundedFloor(bbAreaWeight) + unboundedFloor(bbAspWeight)
+            + utilFloor(bbFromUtilWeight, bbFromUtilPosRein) + utilFloor(bbToUtilWeight, bbToUtilPosRein);
+}
+
+double CompiledConfig::bwEdgeCostFloor() const {
+    return unboundedFloor(bwAspWeight) + utilFloor(bwUtilWeight, bwUtilPosRein);
+}
+
 }
 
 /*
@@ -11,11 +11,13 @@
 // two ways to get value of config:
 // 1. myConfigList.getConfig("ConfigName").getValue<Type>()
 // 2. myConfigList.getConfigValue<Type>("ConfigName")
+// hot paths read a CompiledConfig instead, see ConfigList::compile()
 
 namespace DFSLC {
 
 class Config;
 class ConfigList;
+struct CompiledConfig;
 
 
 enum class ConfigType : unsigned char { BOOL, INT, UINT, LONG64, ULONG64, DOUBLE, FLOAT, CHAR, STRING };
@@ -53,6 +55,7 @@ public:
     }
 
     // gets CONSTANT reference to config's value
+    // a wrong type T rethrows std::bad_any_cast
     template<typename T>
     const T& getValue(){
         try {
@@ -60,11 +63,12 @@ public:
         }
         catch(std::bad_any_cast &e){
             std::cerr << e.what() << std::endl;
-            return T();
+            throw;
         }
     }
 
     // gets CONSTANT reference to config's default value
+    // a wrong type T rethrows std::bad_any_cast
     template<typename T>
     const T& getDefault(){
         try {
@@ -72,7 +76,7 @@ public:
         }
         catch(std::bad_any_cast &e){
             std::cerr << e.what() << std::endl;
-            return T();
+            throw;
         }
     }
 
@@ -155,6 +159,41 @@ public:
     bool readConfigFile(std::string filename);
     void resetAllDefault();
     Config& getConfig(std::string configName);
+    // typed snapshot of all configs, checks types and value ranges.
+    // invalid configs throw std::invalid_argument
+    CompiledConfig compile();
+};
+
+// plain copy of the configs of initAllConfigs(), one field per config
+struct CompiledConfig {
+    int outputLevel;
+    double maxCostCutoff;
+    int pathSearchEngine;
+    int pathSearchThreads;
+    double obAreaWeight;
+    double obUtilWeight;
+    double obAspWeight;
+    double obUtilPosRein;
+    double bwUtilWeight;
+    double bwUtilPosRein;
+    double bwAspWeight;
+    double bbAreaWeight;
+    double bbFromUtilWeight;
+    double bbFromUtilPosRein;
+    double bbToUtilWeight;
+    double bbToUtilPosRein;
+    double bbAspWeight;
+    double bbFlatCost;
+    double wwFlatCost;
+    bool exactAreaMigration;
+    bool migrationAreaLimit;
+    double maxMigrationAreaSingleIter;
+    bool useTilePlane;
+    bool incrementalGraph;
+
+    // lower bounds of a single BB / BW edge cost, read off the cost terms of DFSLegalizer::getEdgeCost(), may be -inf
+    double bbEdgeCostFloor() const;
+    double bwEdgeCostFloor() const;
 };
 
 }
@@ -10,14 +10,82 @@
 #include <sstream>
 #include <ctime> 
 #include <cstdarg>
+#include <limits>
+#include <queue>
+#include <unordered_set>
+#include <algorithm>
+#include <thread>
+#include <mutex>
 
 namespace DFSL {
 
-DFSLNode::DFSLNode(): area(0), index(0) {}
+DFSLNode::DFSLNode(): area(0), index(0), version(0) {}
+
+OverlapOwners::OverlapOwners(): mSize(0) {}
+
+void OverlapOwners::insert(int index){
+    int pos = 0;
+    while (pos < mSize && mIndices[pos] < index){
+        pos++;
+    }
+    if (pos < mSize && mIndices[pos] == index){
+        return;
+    }
+    assert(mSize < CAPACITY);
+    for (int i = mSize; i > pos; i--){
+        mIndices[i] = mIndices[i-1];
+    }
+    mIndices[pos] = index;
+    mSize++;
+}
+
+int OverlapOwners::count(int index) const{
+    for (int i = 0; i < mSize; i++){
+        if (mIndices[i] == index){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int OverlapOwners::size() const{
+    return mSize;
+}
+
+const int* OverlapOwners::begin() const{
+    return mIndices;
+}
+
+const int* OverlapOwners::end() const{
+    return mIndices + mSize;
+}
+
+int OverlapOwners::front() const{
+    assert(mSize > 0);
+    return mIndices[0];
+}
+
+int OverlapOwners::back() const{
+    assert(mSize > 0);
+    return mIndices[mSize-1];
+}
+
+unsigned long long OverlapOwners::key() const{
+    return key(front(), back());
+}
+
+unsigned long long OverlapOwners::key(int index1, int index2){
+    if (index1 > index2){
+        std::swap(index1, index2);
+    }
+    return ((unsigned long long) (unsigned int) index1 << 32) | (unsigned int) index2;
+}
 
 DFSLegalizer::DFSLegalizer()
+    : mEdgeCostStamp(0), mEdgeCostHits(0), mEdgeCostMisses(0), mLF(nullptr), mHasBackup(false), mNodeVersion(0)
 {
     config.initAllConfigs();
+    mConfig = config.compile();
 }
 
 DFSLegalizer::~DFSLegalizer()
@@ -28,7 +96,7 @@ DFSLegalizer::~DFSLegalizer()
 void DFSLegalizer::DFSLPrint(int level, const char* fmt, ...){
     va_list args;
     va_start( args, fmt );
-    if (config.getConfigValue<int>("OutputLevel") >= level){
+    if (mConfig.outputLevel >= level){
         if ( level == DFSL_ERROR )
             printf( "[DFSL] ERROR  : " );
         else if ( level == DFSL_WARNING )
@@ -44,28 +112,98 @@ void DFSLegalizer::DFSLPrint(int level, const char* fmt, ...){
 void DFSLegalizer::initDFSLegalizer(LFLegaliser* floorplan){
     mLF = floorplan;
     mTransientOverlapArea.clear();
+    mHasBackup = false;
+    constructGraph();
+}
+
+void DFSLegalizer::takeBackup(){
+    mLF->takeSnapshot(mBackup);
+    mBackupTransientOverlapArea = mTransientOverlapArea;
+    mHasBackup = true;
+}
+
+bool DFSLegalizer::restoreBackup(){
+    if (!mHasBackup){
+        return false;
+    }
+    mLF->restoreSnapshot(mBackup);
+    mTransientOverlapArea = mBackupTransientOverlapArea;
     constructGraph();
+    return true;
 }
 
 void DFSLegalizer::addBlockNode(Tessera* tess, bool isFixed){
-    DFSLNode newNode;
-    newNode.nodeName = tess->getName();
-    newNode.nodeType = isFixed ? DFSLTessType::FIXED : DFSLTessType::SOFT;
-    newNode.index = mAllNodes.size();
+    DFSLNode& newNode = appendNode(isFixed ? DFSLTessType::FIXED : DFSLTessType::SOFT);
+    fillBlockNode(newNode.index, tess);
+}
+
+void DFSLegalizer::fillBlockNode(int nodeIndex, Tessera* tess){
+    DFSLNode& node = mAllNodes[nodeIndex];
+    node.tileList.clear();
+    node.area = 0;
     for(Tile* tile : tess->TileArr){
-        newNode.tileList.push_back(tile); 
-        newNode.area += tile->getArea();
-        mTilePtr2NodeIndex.insert(std::pair<Tile*,int>(tile, mAllNodes.size()));
+        node.tileList.push_back(tile); 
+        node.area += tile->getArea();
+        mTilePtr2NodeIndex.insert(tile, nodeIndex);
+    }
+}
+
+void DFSLegalizer::fillOverlapNode(int nodeIndex){
+    // the tiles of a pair are in the OverlapArr of both owners, the first owner lists them in constructGraph order
+    DFSLNode& node = mAllNodes[nodeIndex];
+    int firstIndex = node.overlaps.front();
+    int secondIndex = node.overlaps.back();
+    Tessera* firstTess = firstIndex < mFixedTessNum ? mLF->fixedTesserae[firstIndex] : mLF->softTesserae[firstIndex - mFixedTessNum];
+    node.tileList.clear();
+    node.area = 0;
+    for (Tile* tile: firstTess->OverlapArr){
+        bool shared;
+        if (secondIndex < mFixedTessNum){
+            std::vector<int>& owners = tile->OverlapFixedTesseraeIdx;
+            shared = std::find(owners.begin(), owners.end(), secondIndex) != owners.end();
+        }
+        else {
+            std::vector<int>& owners = tile->OverlapSoftTesseraeIdx;
+            shared = std::find(owners.begin(), owners.end(), secondIndex - mFixedTessNum) != owners.end();
+        }
+        if (shared){
+            node.tileList.push_back(tile);
+            node.area += tile->getArea();
+            mTilePtr2NodeIndex.insert(tile, nodeIndex);
+        }
+    }
+}
+
+void DFSLegalizer::syncPlaneMirror(){
+    // graph construction only reads the plane, let it run on the SoA mirror if asked to
+    if (mConfig.useTilePlane){
+        mLF->syncTilePlane();
+    }
+    else {
+        mLF->dropTilePlane();
     }
-    mAllNodes.push_back(newNode);
 }
 
 void DFSLegalizer::constructGraph(){
-    mAllNodes.clear();
+    syncPlaneMirror();
+
+    recycleNodes(mAllNodes);
+    mFreeNodes.clear();
+    mOverlapNodes.clear();
     mTilePtr2NodeIndex.clear();
+    mOverlapRegistry.clear();
     mFixedTessNum = mLF->fixedTesserae.size();
     mSoftTessNum = mLF->softTesserae.size();
 
+    // names are interned once, nodes only carry their index
+    mTessNames.clear();
+    for(Tessera* tess : mLF->fixedTesserae){
+        mTessNames.push_back(tess->getName());
+    }
+    for(Tessera* tess : mLF->softTesserae){
+        mTessNames.push_back(tess->getName());
+    }
+
     // find fixed and soft tess
     for(int t = 0; t < mLF->fixedTesserae.size(); t++){
         Tessera* tess = mLF->fixedTesserae[t];
@@ -91,54 +229,236 @@ void DFSLegalizer::constructGraph(){
             addOverlapInfo(overlap);
         }
     }
-    mOverlapNum = mAllNodes.size() - mFixedTessNum - mSoftTessNum;
 
     // find all blanks
-    std::vector <Cord> blankRecord;
     // This line would cuase bug...
-    DFSLTraverseBlank(mLF->getRandomTile(), blankRecord);
-    mBlankNum = mAllNodes.size() - mFixedTessNum - mSoftTessNum - mOverlapNum;
+    DFSLTraverseBlank(mLF->getRandomTile());
 
 
     // find neighbors
-    // overlap and block
-    int overlapStartIndex = mFixedTessNum + mSoftTessNum;
-    int overlapEndIndex = overlapStartIndex + mOverlapNum;
-    for (int from = overlapStartIndex; from < overlapEndIndex; from++){
-        DFSLNode& overlap = mAllNodes[from];
-        for (int to: overlap.overlaps){
-            if (to >= mFixedTessNum){
-                findEdge(from, to);
+    // overlap and block, block and block, block and whitespace
+    for (int from = 0; from < mAllNodes.size(); from++){
+        addNodeEdges(from);
+    }
+    
+    applyTransientOverlapArea();
+
+    // from here on migrations are journaled, see updateGraph()
+    mNodeDirty.assign(mAllNodes.size(), 0);
+    mDirtyNodes.clear();
+    mWhitespaceBound.clear();
+    mLF->setEditJournal(mConfig.incrementalGraph);
+}
+
+void DFSLegalizer::updateGraph(){
+    syncPlaneMirror();
+
+    // Nodes touched by the migrations since the last build: nodes on the migration paths, every node holding a tile
+    // that touched an edited area before or after the edit, and the owners of the tiles touching it now. Any tile
+    // created, removed or reshaped by an edit touches its area, so every other node and every edge between two other
+    // nodes is unchanged. mNodeDirty is 1 for touched nodes and 2 for nodes rebuilt or created below
+    std::vector<int> dirtyNodes;
+    mNodeDirty.resize(mAllNodes.size(), 0);
+    auto markDirty = [&](int nodeIndex){
+        if (mNodeDirty[nodeIndex] == 0){
+            mNodeDirty[nodeIndex] = 1;
+            dirtyNodes.push_back(nodeIndex);
+        }
+    };
+    for (int nodeIndex: mDirtyNodes){
+        markDirty(nodeIndex);
+    }
+    std::vector<Tile*> touchedTiles;
+    mLF->collectEditedNeighbourhood(touchedTiles);
+    for (Tile* tile: mLF->getEditedTiles()){
+        for (int nodeIndex: mTilePtr2NodeIndex.find(tile)){
+            markDirty(nodeIndex);
+        }
+    }
+    for (Tile* tile: touchedTiles){
+        for (int nodeIndex: mTilePtr2NodeIndex.find(tile)){
+            markDirty(nodeIndex);
+        }
+        if (tile->OwnerFixedTesseraIdx >= 0){
+            markDirty(tile->OwnerFixedTesseraIdx);
+        }
+        if (tile->OwnerSoftTesseraIdx >= 0){
+            markDirty(tile->OwnerSoftTesseraIdx + mFixedTessNum);
+        }
+        for (int fixedIndex: tile->OverlapFixedTesseraeIdx){
+            markDirty(fixedIndex);
+        }
+        for (int softIndex: tile->OverlapSoftTesseraeIdx){
+            markDirty(softIndex + mFixedTessNum);
+        }
+    }
+    // overlap tiles change owners without a plane edit (removeIndexFromOverlap), so overlaps follow their owners
+    for (int overlapIndex: mOverlapNodes){
+        const OverlapOwners& owners = mAllNodes[overlapIndex].overlaps;
+        if (mNodeDirty[owners.front()] != 0 || mNodeDirty[owners.back()] != 0){
+            markDirty(overlapIndex);
+        }
+    }
+
+    // the touched nodes lose all their edges and tiles, the other nodes only their edges into them
+    for (int nodeIndex: dirtyNodes){
+        detachNode(nodeIndex);
+        for (Tile* tile: mAllNodes[nodeIndex].tileList){
+            mTilePtr2NodeIndex.erase(tile, nodeIndex);
+        }
+    }
+
+    // every node keeps its slot while it still holds tiles
+    std::unordered_set<Tile*> touchedSet(touchedTiles.begin(), touchedTiles.end());
+    std::unordered_set<Tile*> editedSet(mLF->getEditedTiles().begin(), mLF->getEditedTiles().end());
+    std::vector<int> rebuiltNodes;
+    for (int nodeIndex: dirtyNodes){
+        DFSLNode& node = mAllNodes[nodeIndex];
+        if (node.nodeType == DFSLTessType::FIXED || node.nodeType == DFSLTessType::SOFT){
+            Tessera* tess = nodeIndex < mFixedTessNum ? mLF->fixedTesserae[nodeIndex] : mLF->softTesserae[nodeIndex - mFixedTessNum];
+            fillBlockNode(nodeIndex, tess);
+        }
+        else if (node.nodeType == DFSLTessType::OVERLAP){
+            fillOverlapNode(nodeIndex);
+            if (node.tileList.empty()){
+                releaseNode(nodeIndex);
+                continue;
+            }
+        }
+        else {
+            // an edited tile that no longer touches the edited areas is gone, one touching them may have been
+            // reshaped or recycled into a new tile at the same address
+            Tile* tile = node.tileList[0];
+            bool alive = touchedSet.count(tile) == 1 ? tile->getType() == tileType::BLANK : editedSet.count(tile) == 0;
+            if (!alive){
+                releaseNode(nodeIndex);
+                continue;
             }
+            node.area = tile->getArea();
+            mTilePtr2NodeIndex.insert(tile, nodeIndex);
         }
+        node.version = ++mNodeVersion;
+        mNodeDirty[nodeIndex] = 2;
+        rebuiltNodes.push_back(nodeIndex);
     }
 
-    // block and block, block and whitespace
-    int softStartIndex = mFixedTessNum;
-    int softEndIndex = softStartIndex + mSoftTessNum;
-    int blankStartIndex = mFixedTessNum + mSoftTessNum + mOverlapNum;
-    int blankEndIndex = blankStartIndex + mBlankNum;
-    for (int from = softStartIndex; from < softEndIndex; from++){
-        std::set<int> allNeighbors;
-        getTessNeighbors(from, allNeighbors);
-        for (int to: allNeighbors){
-            if (softStartIndex <= to && to < softEndIndex){
-                findEdge(from, to);
+    // touched tiles no node holds yet: new blanks, and tiles of owner pairs that had no overlap node
+    auto addRebuilt = [&](int nodeIndex){
+        if (nodeIndex >= mNodeDirty.size()){
+            mNodeDirty.resize(nodeIndex + 1, 0);
+        }
+        mNodeDirty[nodeIndex] = 2;
+        rebuiltNodes.push_back(nodeIndex);
+    };
+    for (Tile* tile: touchedTiles){
+        if (tile->getType() == tileType::BLANK){
+            TileNodeIndex::NodeRange nodes = mTilePtr2NodeIndex.find(tile);
+            if (nodes.begin() == nodes.end()){
+                addRebuilt(addBlankNode(tile));
             }
-            else if (blankStartIndex <= to && to < blankEndIndex){
-                findEdge(from, to);
+        }
+        else if (tile->getType() == tileType::OVERLAP){
+            std::vector<int> owners;
+            for (int fixedIndex: tile->OverlapFixedTesseraeIdx){
+                owners.push_back(fixedIndex);
+            }
+            for (int softIndex: tile->OverlapSoftTesseraeIdx){
+                owners.push_back(softIndex + mFixedTessNum);
+            }
+            for (int i = 0; i < owners.size(); i++){
+                for (int j = i+1; j < owners.size(); j++){
+                    if (mOverlapRegistry.count(OverlapOwners::key(owners[i], owners[j])) == 0){
+                        int nodeIndex = addOverlapNode(owners[i], owners[j]);
+                        fillOverlapNode(nodeIndex);
+                        addRebuilt(nodeIndex);
+                    }
+                }
             }
         }
     }
-    
-    for (OverlapArea& tempArea: mTransientOverlapArea){
-        for (int from = overlapStartIndex; from < overlapEndIndex; from++){
-            DFSLNode& overlap = mAllNodes[from];
-            if (overlap.overlaps.count(tempArea.index1) == 1 && overlap.overlaps.count(tempArea.index2) == 1){
-                overlap.area = tempArea.area;
+
+    // rebuilt nodes get all their edges again, clean nodes get their edges into rebuilt ones
+    for (int nodeIndex: rebuiltNodes){
+        addNodeEdges(nodeIndex);
+    }
+    std::set<int> neighbors;
+    for (int to: rebuiltNodes){
+        DFSLTessType type = mAllNodes[to].nodeType;
+        if (type == DFSLTessType::SOFT){
+            for (int from: mOverlapNodes){
+                if (mNodeDirty[from] == 0 && mAllNodes[from].overlaps.count(to) == 1){
+                    findEdge(from, to);
+                }
+            }
+        }
+        if (type == DFSLTessType::SOFT || type == DFSLTessType::BLANK){
+            neighbors.clear();
+            getTessNeighbors(to, neighbors);
+            for (int from: neighbors){
+                if (mNodeDirty[from] == 0 && mAllNodes[from].nodeType == DFSLTessType::SOFT){
+                    findEdge(from, to);
+                }
             }
         }
     }
+
+    applyTransientOverlapArea();
+
+    for (int nodeIndex: dirtyNodes){
+        mNodeDirty[nodeIndex] = 0;
+    }
+    for (int nodeIndex: rebuiltNodes){
+        mNodeDirty[nodeIndex] = 0;
+    }
+    mDirtyNodes.clear();
+    mWhitespaceBound.clear();
+    mLF->clearEditJournal();
+}
+
+void DFSLegalizer::detachNode(int nodeIndex){
+    DFSLNode& node = mAllNodes[nodeIndex];
+    for (DFSLEdge& edge: node.edgeList){
+        removeFromVector(nodeIndex, mAllNodes[edge.toIndex].predecessors);
+    }
+    node.edgeList.clear();
+    for (int from: node.predecessors){
+        std::vector<DFSLEdge>& edgeList = mAllNodes[from].edgeList;
+        std::vector<DFSLEdge>::iterator it = std::lower_bound(edgeList.begin(), edgeList.end(), nodeIndex, [](const DFSLEdge& edge, int index){
+            return edge.toIndex < index;
+        });
+        assert(it != edgeList.end() && it->toIndex == nodeIndex);
+        edgeList.erase(it);
+    }
+    node.predecessors.clear();
+}
+
+void DFSLegalizer::releaseNode(int nodeIndex){
+    DFSLNode& node = mAllNodes[nodeIndex];
+    if (node.nodeType == DFSLTessType::OVERLAP){
+        mOverlapRegistry.erase(node.overlaps.key());
+        mOverlapNodes.erase(std::find(mOverlapNodes.begin(), mOverlapNodes.end(), nodeIndex));
+    }
+    node.tileList.clear();
+    node.overlaps = OverlapOwners();
+    node.nodeType = DFSLTessType::UNUSED;
+    node.area = 0;
+    mFreeNodes.push_back(nodeIndex);
+}
+
+void DFSLegalizer::addNodeEdges(int fromIndex){
+    DFSLTessType type = mAllNodes[fromIndex].nodeType;
+    if (type == DFSLTessType::OVERLAP || type == DFSLTessType::SOFT){
+        addBoundaryEdges(fromIndex, -1);
+    }
+}
+
+void DFSLegalizer::applyTransientOverlapArea(){
+    for (OverlapArea& tempArea: mTransientOverlapArea){
+        std::unordered_map<unsigned long long, int>::iterator it = mOverlapRegistry.find(OverlapOwners::key(tempArea.index1, tempArea.index2));
+        if (it != mOverlapRegistry.end()){
+            mAllNodes[it->second].area = tempArea.area;
+        }
+    }
 }
 
 void DFSLegalizer::addOverlapInfo(Tile* tile){
@@ -162,101 +482,137 @@ void DFSLegalizer::addOverlapInfo(Tile* tile){
 }
 
 void DFSLegalizer::addSingleOverlapInfo(Tile* tile, int overlapIdx1, int overlapIdx2){
-    bool found = false;
-    for (int i = mFixedTessNum + mSoftTessNum; i < mAllNodes.size(); i++){
-        DFSLNode& tess = mAllNodes[i];
-        if (tess.overlaps.count(overlapIdx1) == 1 && tess.overlaps.count(overlapIdx2) == 1){
-            for (Tile* existingTile: tess.tileList){
-                if (existingTile == tile){
-                    found = true;
-                    break;
-                }
-            }
-            if (!found){
-                tess.tileList.push_back(tile);
-                tess.area += tile->getArea();
-                mTilePtr2NodeIndex.insert(std::pair<Tile*,int>(tile, i));
-                found = true;
+    unsigned long long key = OverlapOwners::key(overlapIdx1, overlapIdx2);
+    std::unordered_map<unsigned long long, int>::iterator it = mOverlapRegistry.find(key);
+    int nodeIndex;
+    if (it != mOverlapRegistry.end()){
+        // a tile is listed in the OverlapArr of each of its owners, only add it once
+        nodeIndex = it->second;
+        for (int existingNode: mTilePtr2NodeIndex.find(tile)){
+            if (existingNode == nodeIndex){
+                return;
             }
-            break;
         }
     }
-    if (!found){
-        DFSLNode newNode;
-        newNode.area += tile->getArea();
-        newNode.tileList.push_back(tile);
-        newNode.overlaps.insert(overlapIdx1);
-        newNode.overlaps.insert(overlapIdx2);
-        newNode.nodeName = toOverlapName(overlapIdx1, overlapIdx2); 
-        newNode.nodeType = DFSLTessType::OVERLAP;
-        newNode.index = mAllNodes.size();
-        mTilePtr2NodeIndex.insert(std::pair<Tile*,int>(tile, mAllNodes.size()));
-        mAllNodes.push_back(newNode);
+    else {
+        nodeIndex = addOverlapNode(overlapIdx1, overlapIdx2);
     }
+    DFSLNode& tess = mAllNodes[nodeIndex];
+    tess.tileList.push_back(tile);
+    tess.area += tile->getArea();
+    mTilePtr2NodeIndex.insert(tile, nodeIndex);
 }
 
-std::string DFSLegalizer::toOverlapName(int tessIndex1, int tessIndex2){
-    std::string name1 = mAllNodes[tessIndex1].nodeName;
-    std::string name2 = mAllNodes[tessIndex2].nodeName;
-    return "OVERLAP_" + name1 + "_" + name2;
+int DFSLegalizer::addOverlapNode(int overlapIdx1, int overlapIdx2){
+    DFSLNode& newNode = appendNode(DFSLTessType::OVERLAP);
+    newNode.overlaps.insert(overlapIdx1);
+    newNode.overlaps.insert(overlapIdx2);
+    mOverlapRegistry[newNode.overlaps.key()] = newNode.index;
+    mOverlapNodes.push_back(newNode.index);
+    return newNode.index;
 }
 
-void DFSLegalizer::DFSLTraverseBlank(Tile* tile, std::vector <Cord> &record){
-    record.push_back(tile->getLowerLeft());
-    
-    if(tile->getType() == tileType::BLANK){
-        DFSLNode newNode;
-        newNode.tileList.push_back(tile);
-        newNode.nodeName = std::to_string((intptr_t)tile);
-        newNode.nodeType = DFSLTessType::BLANK;
-        newNode.index = mAllNodes.size();
-        newNode.area += tile->getArea();
-        mTilePtr2NodeIndex.insert(std::pair<Tile*,int>(tile, mAllNodes.size()));
-        mAllNodes.push_back(newNode);
+DFSLNode& DFSLegalizer::appendNode(DFSLTessType type){
+    // slots released by updateGraph() are taken first, then nodes of the previous graph are recycled,
+    // their tile lists keep their capacity
+    int nodeIndex;
+    if (!mFreeNodes.empty()){
+        nodeIndex = mFreeNodes.back();
+        mFreeNodes.pop_back();
     }
-
-    if(tile->rt != nullptr){        
-        if(!checkVectorInclude(record, tile->rt->getLowerLeft())){
-            DFSLTraverseBlank(tile->rt, record);
+    else {
+        if (mSpareNodes.empty()){
+            mAllNodes.emplace_back();
         }
-    }
-
-    if(tile->lb != nullptr){
-        if(!checkVectorInclude(record, tile->lb->getLowerLeft())){
-            DFSLTraverseBlank(tile->lb, record);
+        else {
+            mAllNodes.push_back(std::move(mSpareNodes.back()));
+            mSpareNodes.pop_back();
         }
+        nodeIndex = mAllNodes.size() - 1;
+    }
+    DFSLNode& node = mAllNodes[nodeIndex];
+    node.tileList.clear();
+    node.edgeList.clear();
+    node.predecessors.clear();
+    node.overlaps = OverlapOwners();
+    node.nodeType = type;
+    node.area = 0;
+    node.index = nodeIndex;
+    node.version = ++mNodeVersion;
+    return node;
+}
+
+void DFSLegalizer::recycleNodes(std::vector<DFSLNode>& nodes){
+    for (DFSLNode& node: nodes){
+        mSpareNodes.push_back(std::move(node));
     }
+    nodes.clear();
+}
 
-    if(tile->bl != nullptr){
-        if(!checkVectorInclude(record, tile->bl->getLowerLeft())){
-            DFSLTraverseBlank(tile->bl, record);
-        }
+std::string DFSLegalizer::getNodeName(int nodeIndex) const{
+    const DFSLNode& node = mAllNodes[nodeIndex];
+    switch (node.nodeType)
+    {
+    case DFSLTessType::FIXED:
+    case DFSLTessType::SOFT:
+        return mTessNames[nodeIndex];
+    case DFSLTessType::OVERLAP:
+        return "OVERLAP_" + mTessNames[node.overlaps.front()] + "_" + mTessNames[node.overlaps.back()];
+    case DFSLTessType::BLANK:
+        return std::to_string((intptr_t)node.tileList[0]);
+    default:
+        return "UNUSED";
     }
+}
 
-    if(tile->tr != nullptr){
-        if(!checkVectorInclude(record, tile->tr->getLowerLeft())){
-            DFSLTraverseBlank(tile->tr, record);
+void DFSLegalizer::DFSLTraverseBlank(Tile* tile){
+    mLF->enumerateAllTiles(tile, [this](Tile* t){
+        if(t->getType() == tileType::BLANK){
+            addBlankNode(t);
         }
-    }
-    
-    return;
+    });
+}
+
+int DFSLegalizer::addBlankNode(Tile* tile){
+    DFSLNode& newNode = appendNode(DFSLTessType::BLANK);
+    newNode.tileList.push_back(tile);
+    newNode.area += tile->getArea();
+    mTilePtr2NodeIndex.insert(tile, newNode.index);
+    return newNode.index;
 }
 
 void DFSLegalizer::findEdge(int fromIndex, int toIndex){
+    addBoundaryEdges(fromIndex, toIndex);
+}
+
+void DFSLegalizer::addBoundaryEdges(int fromIndex, int onlyTo){
     DFSLNode& fromNode = mAllNodes[fromIndex];
-    DFSLNode& toNode = mAllNodes[toIndex];
 
     // this takes care of the case where a block is completely covered by overlap tiles,
     // no edge from overlap to block
-    if (fromNode.tileList.size() == 0 || toNode.tileList.size() == 0){
+    if (fromNode.tileList.size() == 0 || (onlyTo != -1 && mAllNodes[onlyTo].tileList.size() == 0)){
         return;
     }
-    std::vector<Segment> allTangentSegments;
+
+    auto isTarget = [&](int nodeIndex){
+        if (onlyTo != -1 && nodeIndex != onlyTo){
+            return false;
+        }
+        if (fromNode.nodeType == DFSLTessType::OVERLAP){
+            return nodeIndex >= mFixedTessNum && fromNode.overlaps.count(nodeIndex) == 1;
+        }
+        DFSLTessType type = mAllNodes[nodeIndex].nodeType;
+        return nodeIndex != fromIndex && (type == DFSLTessType::SOFT || type == DFSLTessType::BLANK);
+    };
+
+    // walk the boundary of the node once, every tangent is tagged with the node on the other side
+    std::vector<Tile*> neighbors;
     for (int dir = 0; dir < 4; dir++){
         // find Top, right, bottom, left neighbros
-        std::vector<Segment> currentSegment;
+        std::vector<TangentRecord>& records = mTangentRecords[dir];
+        records.clear();
         for (Tile* tile: fromNode.tileList){
-            std::vector<Tile*> neighbors;
+            neighbors.clear();
             switch (dir) {
             case 0:
                 mLF->findTopNeighbors(tile, neighbors);
@@ -273,93 +629,132 @@ void DFSLegalizer::findEdge(int fromIndex, int toIndex){
             }
             
             for (Tile* neighbor: neighbors){
-                auto itlow = mTilePtr2NodeIndex.lower_bound(neighbor);
-                auto itup = mTilePtr2NodeIndex.upper_bound(neighbor);
-                for (auto it = itlow; it != itup; ++it){
-                    int nodeIndex = it->second;
-                    if (nodeIndex == toIndex){
-                        // find tangent
-                        Segment tangent;
-                        Cord fromStart, fromEnd, toStart, toEnd;
-                        if (dir == 0){
-                            // neighbor on top of fromNode 
-                            fromStart = tile->getUpperLeft();
-                            fromEnd = tile->getUpperRight();
-                            toStart = neighbor->getLowerLeft(); 
-                            toEnd = neighbor->getLowerRight();
-                            tangent.direction = DIRECTION::TOP;
-                        }
-                        else if (dir == 1){
-                            // neighbor is right of fromNode 
-                            fromStart = tile->getLowerRight();
-                            fromEnd = tile->getUpperRight();
-                            toStart = neighbor->getLowerLeft(); 
-                            toEnd = neighbor->getUpperLeft();
-                            tangent.direction = DIRECTION::RIGHT;
-                        }
-                        else if (dir == 2){
-                            // neighbor is bottom of fromNode 
-                            fromStart = tile->getLowerLeft();
-                            fromEnd = tile->getLowerRight();
-                            toStart = neighbor->getUpperLeft(); 
-                            toEnd = neighbor->getUpperRight();
-                            tangent.direction = DIRECTION::DOWN;
-                        }
-                        else {
-                            // neighbor is left of fromNode 
-                            fromStart = tile->getLowerLeft();
-                            fromEnd = tile->getUpperLeft();
-                            toStart = neighbor->getLowerRight(); 
-                            toEnd = neighbor->getUpperRight();
-                            tangent.direction = DIRECTION::LEFT;
-                        }
-                        tangent.segStart = fromStart <= toStart ? toStart : fromStart;
-                        tangent.segEnd = fromEnd <= toEnd ? fromEnd : toEnd;
-                        currentSegment.push_back(tangent);
+                for (int nodeIndex : mTilePtr2NodeIndex.find(neighbor)){
+                    if (!isTarget(nodeIndex)){
+                        continue;
                     }
+                    // find tangent
+                    Segment tangent;
+                    Cord fromStart, fromEnd, toStart, toEnd;
+                    if (dir == 0){
+                        // neighbor on top of fromNode 
+                        fromStart = tile->getUpperLeft();
+                        fromEnd = tile->getUpperRight();
+                        toStart = neighbor->getLowerLeft(); 
+                        toEnd = neighbor->getLowerRight();
+                        tangent.direction = DIRECTION::TOP;
+                    }
+                    else if (dir == 1){
+                        // neighbor is right of fromNode 
+                        fromStart = tile->getLowerRight();
+                        fromEnd = tile->getUpperRight();
+                        toStart = neighbor->getLowerLeft(); 
+                        toEnd = neighbor->getUpperLeft();
+                        tangent.direction = DIRECTION::RIGHT;
+                    }
+                    else if (dir == 2){
+                        // neighbor is bottom of fromNode 
+                        fromStart = tile->getLowerLeft();
+                        fromEnd = tile->getLowerRight();
+                        toStart = neighbor->getUpperLeft(); 
+                        toEnd = neighbor->getUpperRight();
+                        tangent.direction = DIRECTION::DOWN;
+                    }
+                    else {
+                        // neighbor is left of fromNode 
+                        fromStart = tile->getLowerLeft();
+                        fromEnd = tile->getUpperLeft();
+                        toStart = neighbor->getLowerRight(); 
+                        toEnd = neighbor->getUpperRight();
+                        tangent.direction = DIRECTION::LEFT;
+                    }
+                    tangent.segStart = fromStart <= toStart ? toStart : fromStart;
+                    tangent.segEnd = fromEnd <= toEnd ? fromEnd : toEnd;
+                    records.push_back({nodeIndex, tangent});
                 }
             }
         }
-        
-        // check segment, splice touching segments together and add to allTangentSegments
-        int segLength = 0;
-        if (currentSegment.size() > 0){
-            if (dir == 0 || dir == 2){
-                std::sort(currentSegment.begin(), currentSegment.end(), compareXSegment);
+        // bucket by destination, the walk order is kept inside each bucket
+        std::stable_sort(records.begin(), records.end(), [](const TangentRecord& a, const TangentRecord& b){
+            return a.toIndex < b.toIndex;
+        });
+    }
+
+    // destinations in ascending order: overlaps point to every soft owner, blocks to every soft or blank neighbor
+    std::vector<int> targets;
+    if (fromNode.nodeType == DFSLTessType::OVERLAP){
+        for (int to: fromNode.overlaps){
+            if (to >= mFixedTessNum && mAllNodes[to].tileList.size() > 0 && (onlyTo == -1 || to == onlyTo)){
+                targets.push_back(to);
             }
-            else {
-                std::sort(currentSegment.begin(), currentSegment.end(), compareYSegment);
-            }
-            Cord segBegin = currentSegment.front().segStart;
-            for (int j = 1; j < currentSegment.size(); j++){
-                if (currentSegment[j].segStart != currentSegment[j-1].segEnd){
-                    Cord segEnd = currentSegment[j-1].segEnd;
-                    Segment splicedSegment;
-                    splicedSegment.segStart = segBegin;
-                    splicedSegment.segEnd = segEnd;
-                    splicedSegment.direction = currentSegment[j-1].direction;
-                    allTangentSegments.push_back(splicedSegment);
-                    segLength += (segEnd.x - segBegin.x) + (segEnd.y - segBegin.y);  
-
-                    segBegin = currentSegment[j].segStart;
-                }
+        }
+    }
+    else {
+        for (int dir = 0; dir < 4; dir++){
+            for (const TangentRecord& record: mTangentRecords[dir]){
+                targets.push_back(record.toIndex);
             }
-            Cord segEnd = currentSegment.back().segEnd;
+        }
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+    }
+
+    int cursor[4] = {0, 0, 0, 0};
+    std::vector<Segment> currentSegment;
+    for (int toIndex: targets){
+        // construct edge in graph
+        DFSLEdge newEdge;
+        newEdge.fromIndex = fromIndex;
+        newEdge.toIndex = toIndex; 
+        for (int dir = 0; dir < 4; dir++){
+            const std::vector<TangentRecord>& records = mTangentRecords[dir];
+            currentSegment.clear();
+            while (cursor[dir] < records.size() && records[cursor[dir]].toIndex < toIndex){
+                cursor[dir]++;
+            }
+            while (cursor[dir] < records.size() && records[cursor[dir]].toIndex == toIndex){
+                currentSegment.push_back(records[cursor[dir]++].segment);
+            }
+            spliceTangentSegments(currentSegment, dir, newEdge.tangentSegments);
+        }
+        // edge lists are kept sorted by target, a graph build only ever appends
+        std::vector<DFSLEdge>& edgeList = fromNode.edgeList;
+        std::vector<DFSLEdge>::iterator position = std::upper_bound(edgeList.begin(), edgeList.end(), toIndex, [](int index, const DFSLEdge& edge){
+            return index < edge.toIndex;
+        });
+        edgeList.insert(position, std::move(newEdge));
+        mAllNodes[toIndex].predecessors.push_back(fromIndex);
+    }
+}
+
+// check segment, splice touching segments together and add to allTangentSegments
+void DFSLegalizer::spliceTangentSegments(std::vector<Segment>& currentSegment, int dir, std::vector<Segment>& allTangentSegments){
+    if (currentSegment.size() == 0){
+        return;
+    }
+    if (dir == 0 || dir == 2){
+        std::sort(currentSegment.begin(), currentSegment.end(), compareXSegment);
+    }
+    else {
+        std::sort(currentSegment.begin(), currentSegment.end(), compareYSegment);
+    }
+    Cord segBegin = currentSegment.front().segStart;
+    for (int j = 1; j < currentSegment.size(); j++){
+        if (currentSegment[j].segStart != currentSegment[j-1].segEnd){
             Segment splicedSegment;
             splicedSegment.segStart = segBegin;
-            splicedSegment.segEnd = segEnd;
-            splicedSegment.direction = currentSegment.back().direction;
+            splicedSegment.segEnd = currentSegment[j-1].segEnd;
+            splicedSegment.direction = currentSegment[j-1].direction;
             allTangentSegments.push_back(splicedSegment);
-            segLength += (segEnd.x - segBegin.x) + (segEnd.y - segBegin.y);  
+
+            segBegin = currentSegment[j].segStart;
         }
     }
-
-    // construct edge in graph
-    DFSLEdge newEdge;
-    newEdge.tangentSegments = allTangentSegments;
-    newEdge.fromIndex = fromIndex;
-    newEdge.toIndex = toIndex; 
-    mAllNodes[fromIndex].edgeList.push_back(newEdge);
+    Segment splicedSegment;
+    splicedSegment.segStart = segBegin;
+    splicedSegment.segEnd = currentSegment.back().segEnd;
+    splicedSegment.direction = currentSegment.back().direction;
+    allTangentSegments.push_back(splicedSegment);
 }
 
 void DFSLegalizer::getTessNeighbors(int nodeId, std::set<int>& allNeighbors){
@@ -370,10 +765,7 @@ void DFSLegalizer::getTessNeighbors(int nodeId, std::set<int>& allNeighbors){
     }
 
     for (Tile* tile : allNeighborTiles){
-        auto itlow = mTilePtr2NodeIndex.lower_bound(tile);
-        auto itup = mTilePtr2NodeIndex.upper_bound(tile);
-        for (auto it = itlow; it != itup; ++it){
-            int nodeIndex = it->second;
+        for (int nodeIndex : mTilePtr2NodeIndex.find(tile)){
             if (nodeIndex != nodeId){
                 allNeighbors.insert(nodeIndex);
             }
@@ -382,24 +774,21 @@ void DFSLegalizer::getTessNeighbors(int nodeId, std::set<int>& allNeighbors){
 }
 
 void DFSLegalizer::printFloorplanStats(){
-    DFSLPrint(2, "Remaining overlaps: %d\n", mOverlapNum);
-    long overlapArea = 0, physicalArea = 0, dieArea = mLF->getCanvasWidth() * mLF->getCanvasHeight();
-    int overlapStart = mFixedTessNum + mSoftTessNum;
-    int overlapEnd = overlapStart + mOverlapNum;
-    for (int i = overlapStart; i < overlapEnd; i++){
+    DFSLPrint(2, "Remaining overlaps: %d\n", (int) mOverlapNodes.size());
+    area_t overlapArea = 0, physicalArea = 0, dieArea = (area_t) mLF->getCanvasWidth() * mLF->getCanvasHeight();
+    for (int i: mOverlapNodes){
         DFSLNode& currentOverlap = mAllNodes[i];
         overlapArea += currentOverlap.area;
     }
     physicalArea = dieArea;
-    int blankStartIndex = mFixedTessNum + mSoftTessNum + mOverlapNum;
-    int blankEndIndex = blankStartIndex + mBlankNum;
-    for (int i = blankStartIndex; i < blankEndIndex; i++){
-        DFSLNode& currentBlank = mAllNodes[i];
-        physicalArea -= currentBlank.area;
+    for (DFSLNode& currentBlank: mAllNodes){
+        if (currentBlank.nodeType == DFSLTessType::BLANK){
+            physicalArea -= currentBlank.area;
+        }
     }
     double overlapOverDie = (double) overlapArea / (double) dieArea;
     double overlapOverPhysical = (double) overlapArea / (double) physicalArea;
-    DFSLPrint(2, "Total Overlap Area: %6ld\t(o/d = %5.4f%\to/p = %5.4f%)\n", overlapArea, overlapOverDie * 100, overlapOverPhysical * 100);
+    DFSLPrint(2, "Total Overlap Area: %6lld\t(o/d = %5.4f%\to/p = %5.4f%)\n", (long long) overlapArea, overlapOverDie * 100, overlapOverPhysical * 100);
 }
 
 // mode 0: resolve area big -> area small
@@ -407,7 +796,12 @@ void DFSLegalizer::printFloorplanStats(){
 // mode 2: resolve overlaps near center -> outer edge
 // mode 3: completely random
 RESULT DFSLegalizer::legalize(int mode){
-    // todo: create backup (deep copy)
+    compileConfig();
+    // the graph was built under the configs of initDFSLegalizer(), rebuild it if migrations are journaled differently now
+    if (mConfig.incrementalGraph != mLF->isEditJournalOn()){
+        constructGraph();
+    }
+
     RESULT result;
     int iteration = 0;
     std::srand(69);
@@ -421,24 +815,22 @@ RESULT DFSLegalizer::legalize(int mode){
             printFloorplanStats();
         }
         std::cout << std::flush;
-        int overlapStart = mFixedTessNum + mSoftTessNum;
-        int overlapEnd = overlapStart + mOverlapNum;
-
-        if (overlapStart == overlapEnd){
+        if (mOverlapNodes.empty()){
             break;
         }
 
         bool overlapResolved = false;
-        std::vector<bool> solveable(mAllNodes.size(), true);
-        int resolvableOverlaps = mOverlapNum;
+        // indexed like mOverlapNodes, which does not change until the graph is refreshed
+        std::vector<bool> solveable(mOverlapNodes.size(), true);
+        int resolvableOverlaps = mOverlapNodes.size();
         
         while (!overlapResolved){
-            int bestMetric;
+            area_t bestMetric;
             if (mode == 1 || mode == 2){
-                bestMetric = INT_MAX;
+                bestMetric = std::numeric_limits<area_t>::max();
             }
             else {
-                bestMetric = -INT_MAX;
+                bestMetric = -std::numeric_limits<area_t>::max();
             }
 
             if (resolvableOverlaps == 0){
@@ -449,8 +841,8 @@ RESULT DFSLegalizer::legalize(int mode){
 
             int bestIndex = -1;
             int mode3RandomChoice = std::rand() % resolvableOverlaps;
-            for (int i = overlapStart; i < overlapEnd; i++){
-                DFSLNode& currentOverlap = mAllNodes[i];
+            for (int i = 0; i < mOverlapNodes.size(); i++){
+                DFSLNode& currentOverlap = mAllNodes[mOverlapNodes[i]];
                 switch (mode)
                 {
                 case 1:
@@ -461,12 +853,12 @@ RESULT DFSLegalizer::legalize(int mode){
                     break;
                 
                 case 2:{
-                    int chipCenterx = mLF->getCanvasWidth() / 2;
-                    int chipCentery = mLF->getCanvasHeight() / 2;
+                    len_t chipCenterx = mLF->getCanvasWidth() / 2;
+                    len_t chipCentery = mLF->getCanvasHeight() / 2;
                     
-                    int min_x, max_x, min_y, max_y;
-                    min_x = min_y = INT_MAX;
-                    max_x = max_y = -INT_MAX;
+                    len_t min_x, max_x, min_y, max_y;
+                    min_x = min_y = std::numeric_limits<len_t>::max();
+                    max_x = max_y = -std::numeric_limits<len_t>::max();
 
                     for (Tile* tile: currentOverlap.tileList){
                         if (tile->getLowerLeft().x < min_x){
@@ -482,9 +874,9 @@ RESULT DFSLegalizer::legalize(int mode){
                             max_y = tile->getUpperRight().y;
                         }
                     }
-                    int overlapCenterx = (min_x + max_x) / 2;
-                    int overlapCentery = (min_y + max_y) / 2;
-                    int distSquared = pow(overlapCenterx - chipCenterx, 2) + pow(overlapCentery - chipCentery, 2);
+                    len_t overlapCenterx = (min_x + max_x) / 2;
+                    len_t overlapCentery = (min_y + max_y) / 2;
+                    area_t distSquared = pow(overlapCenterx - chipCenterx, 2) + pow(overlapCentery - chipCentery, 2);
 
                     if (distSquared < bestMetric && solveable[i]){
                         bestMetric = distSquared;
@@ -515,7 +907,7 @@ RESULT DFSLegalizer::legalize(int mode){
                 }
             }
 
-            solveable[bestIndex] = overlapResolved = migrateOverlap(bestIndex);
+            solveable[bestIndex] = overlapResolved = migrateOverlap(mOverlapNodes[bestIndex]);
             if (!overlapResolved){
                 resolvableOverlaps--;
             }
@@ -529,7 +921,12 @@ RESULT DFSLegalizer::legalize(int mode){
             }
         }
 
-        constructGraph();
+        if (mConfig.incrementalGraph){
+            updateGraph();
+        }
+        else {
+            constructGraph();
+        }
         iteration++;
         
     }
@@ -542,36 +939,36 @@ RESULT DFSLegalizer::legalize(int mode){
     int nodeEnd = mFixedTessNum + mSoftTessNum;
     int violations = 0;
     for (int i = nodeStart; i < nodeEnd; i++){
-        int requiredArea = i < mFixedTessNum ? mLF->fixedTesserae[i]->getLegalArea() :  mLF->softTesserae[i-mFixedTessNum]->getLegalArea();
+        area_t requiredArea = i < mFixedTessNum ? mLF->fixedTesserae[i]->getLegalArea() :  mLF->softTesserae[i-mFixedTessNum]->getLegalArea();
         if (requiredArea == 0){
             continue;
         }
         DFSLNode& node = mAllNodes[i];
         LegalInfo legal = getLegalInfo(node.tileList);
         if (legal.util < UTIL_RULE){
-            DFSLPrint(1, "util for %s fail (%4.3f < %4.3f)\n", node.nodeName.c_str(), legal.util, UTIL_RULE);
+            DFSLPrint(1, "util for %s fail (%4.3f < %4.3f)\n", getNodeName(node.index).c_str(), legal.util, UTIL_RULE);
             result = RESULT::CONSTRAINT_FAIL;
             violations++;
         }
 
         if (legal.aspectRatio > ASPECT_RATIO_RULE && node.nodeType == DFSLTessType::SOFT){
-            DFSLPrint(1, "aspect ratio for %s fail (%3.2f > %3.2f)\n", node.nodeName.c_str(), legal.aspectRatio, ASPECT_RATIO_RULE);
+            DFSLPrint(1, "aspect ratio for %s fail (%3.2f > %3.2f)\n", getNodeName(node.index).c_str(), legal.aspectRatio, ASPECT_RATIO_RULE);
             result = RESULT::CONSTRAINT_FAIL;
             violations++;
         }
         else if (legal.aspectRatio < 1.0 / ASPECT_RATIO_RULE && node.nodeType == DFSLTessType::SOFT){
-            DFSLPrint(1, "aspect ratio for %s fail (%3.2f < %3.2f)\n", node.nodeName.c_str(), legal.aspectRatio, 1.0 / ASPECT_RATIO_RULE);
+            DFSLPrint(1, "aspect ratio for %s fail (%3.2f < %3.2f)\n", getNodeName(node.index).c_str(), legal.aspectRatio, 1.0 / ASPECT_RATIO_RULE);
             result = RESULT::CONSTRAINT_FAIL;
             violations++;
         }
 
         if (legal.actualArea < requiredArea && node.nodeType == DFSLTessType::SOFT){
-            DFSLPrint(1, "Required area for soft block %s fail (%d < %d)\n", node.nodeName.c_str(), legal.actualArea, requiredArea);
+            DFSLPrint(1, "Required area for soft block %s fail (%lld < %lld)\n", getNodeName(node.index).c_str(), (long long) legal.actualArea, (long long) requiredArea);
             result = RESULT::CONSTRAINT_FAIL; 
             violations++;           
         } 
         else if (legal.actualArea != requiredArea && node.nodeType == DFSLTessType::FIXED){
-            DFSLPrint(1, "Required area for fixed block %s fail (%d != %d)\n", node.nodeName.c_str(), legal.actualArea, requiredArea);
+            DFSLPrint(1, "Required area for fixed block %s fail (%lld != %lld)\n", getNodeName(node.index).c_str(), (long long) legal.actualArea, (long long) requiredArea);
             result = RESULT::CONSTRAINT_FAIL;
             violations++;
         }
@@ -590,13 +987,13 @@ RESULT DFSLegalizer::legalize(int mode){
                 << gtl::delta(boundingBox, gtl::orientation_2d_enum::HORIZONTAL) << ", H="
                 << gtl::delta(boundingBox, gtl::orientation_2d_enum::VERTICAL) << '\n';
             }
-            DFSLPrint(1, "Block %s has %d disjoint components:\n%s", node.nodeName.c_str(), polyContainer.size(), messageStream.str().c_str());
+            DFSLPrint(1, "Block %s has %d disjoint components:\n%s", getNodeName(node.index).c_str(), polyContainer.size(), messageStream.str().c_str());
             result = RESULT::CONSTRAINT_FAIL;
             violations++;
         }
         else {
             if (polyContainer[0].size_holes() > 0){
-                DFSLPrint(1, "Block %s has %d holes\n", node.nodeName.c_str(), polyContainer[0].size_holes());
+                DFSLPrint(1, "Block %s has %d holes\n", getNodeName(node.index).c_str(), polyContainer[0].size_holes());
                 result = RESULT::CONSTRAINT_FAIL;
                 violations++;
             }
@@ -609,47 +1006,47 @@ RESULT DFSLegalizer::legalize(int mode){
 
 // find actual rectangle, equal to resolvable area
 Rectangle DFSLegalizer::getRectFromEdge(MigrationEdge& edge, bool findRemainder, Rectangle& remainderRect, bool useCeil = true){
-    int xl = 0, xh = 0, yl = 0, yh = 0;
-    int rxl = 0, rxh = 0, ryl = 0, ryh = 0;
+    len_t xl = 0, xh = 0, yl = 0, yh = 0;
+    len_t rxl = 0, rxh = 0, ryl = 0, ryh = 0;
     if (edge.segment.direction == DIRECTION::TOP){
         xl = edge.segment.segStart.x < edge.segment.segEnd.x ? edge.segment.segStart.x : edge.segment.segEnd.x;
         xh = edge.segment.segStart.x < edge.segment.segEnd.x ? edge.segment.segEnd.x : edge.segment.segStart.x;
         yl = edge.segment.segStart.y;
-        int width = xh - xl;
-        int requiredHeight = useCeil ? ceil((double) mResolvableArea / (double) width) : floor((double) mResolvableArea / (double) width);
+        len_t width = xh - xl;
+        len_t requiredHeight = useCeil ? ceil((double) mResolvableArea / (double) width) : floor((double) mResolvableArea / (double) width);
         yh = yl + requiredHeight;
     }
     else if (edge.segment.direction == DIRECTION::RIGHT){
         yl = edge.segment.segStart.y < edge.segment.segEnd.y ? edge.segment.segStart.y : edge.segment.segEnd.y;
         yh = edge.segment.segStart.y < edge.segment.segEnd.y ? edge.segment.segEnd.y : edge.segment.segStart.y;
         xl = edge.segment.segStart.x;
-        int height = yh - yl;
-        int requiredWidth = useCeil ? ceil((double) mResolvableArea / (double) height) : floor((double) mResolvableArea / (double) height);
+        len_t height = yh - yl;
+        len_t requiredWidth = useCeil ? ceil((double) mResolvableArea / (double) height) : floor((double) mResolvableArea / (double) height);
         xh = xl + requiredWidth;
     }
     else if (edge.segment.direction == DIRECTION::DOWN){
         xl = edge.segment.segStart.x < edge.segment.segEnd.x ? edge.segment.segStart.x : edge.segment.segEnd.x;
         xh = edge.segment.segStart.x < edge.segment.segEnd.x ? edge.segment.segEnd.x : edge.segment.segStart.x;
         yh = edge.segment.segStart.y;
-        int width = xh - xl;
-        int requiredHeight = useCeil ? ceil((double) mResolvableArea / (double) width) : floor((double) mResolvableArea / (double) width);
+        len_t width = xh - xl;
+        len_t requiredHeight = useCeil ? ceil((double) mResolvableArea / (double) width) : floor((double) mResolvableArea / (double) width);
         yl = yh - requiredHeight;
     }
     else if (edge.segment.direction == DIRECTION::LEFT) {
         yl = edge.segment.segStart.y < edge.segment.segEnd.y ? edge.segment.segStart.y : edge.segment.segEnd.y;
         yh = edge.segment.segStart.y < edge.segment.segEnd.y ? edge.segment.segEnd.y : edge.segment.segStart.y;
         xh = edge.segment.segStart.x;
-        int height = yh - yl;
-        int requiredWidth = useCeil ? ceil((double) mResolvableArea / (double) height) : floor((double) mResolvableArea / (double) height);
+        len_t height = yh - yl;
+        len_t requiredWidth = useCeil ? ceil((double) mResolvableArea / (double) height) : floor((double) mResolvableArea / (double) height);
         xl = xh - requiredWidth;
     }
     else {
         DFSLNode& fromNode = mAllNodes[edge.fromIndex];
         DFSLNode& toNode = mAllNodes[edge.toIndex];
-        DFSLPrint(1, "Edge (%s -> %s) has no DIRECTION\n", fromNode.nodeName.c_str(), toNode.nodeName.c_str());
+        DFSLPrint(1, "Edge (%s -> %s) has no DIRECTION\n", getNodeName(fromNode.index).c_str(), getNodeName(toNode.index).c_str());
     }
     
-    int remainingArea = mResolvableArea - (xh - xl) * (yh - yl);
+    area_t remainingArea = mResolvableArea - (area_t) (xh - xl) * (yh - yl);
     if (remainingArea > 0 && findRemainder){    
         if (edge.segment.direction == DIRECTION::TOP){
             rxl = xl;
@@ -678,7 +1075,7 @@ Rectangle DFSLegalizer::getRectFromEdge(MigrationEdge& edge, bool findRemainder,
         else {
             DFSLNode& fromNode = mAllNodes[edge.fromIndex];
             DFSLNode& toNode = mAllNodes[edge.toIndex];
-            DFSLPrint(1, "Edge (%s -> %s) has no DIRECTION\n", fromNode.nodeName.c_str(), toNode.nodeName.c_str());
+            DFSLPrint(1, "Edge (%s -> %s) has no DIRECTION\n", getNodeName(fromNode.index).c_str(), getNodeName(toNode.index).c_str());
         }
         remainderRect = Rectangle(rxl, ryl, rxh, ryh);
     }
@@ -756,14 +1153,14 @@ bool DFSLegalizer::splitOverlap(MigrationEdge& edge, std::vector<Tile*>& newTile
     // From ascending order of area, resolve each overlap tile individually 
     std::vector<Tile*>& overlapTileList = fromNode.tileList;
     std::vector<bool> tileChosen(overlapTileList.size(), false);
-    int remainingMigrateArea = mResolvableArea;
+    area_t remainingMigrateArea = mResolvableArea;
     int smallestRecIndex = -1;
     while (true){
         // find Tile with smallest area
-        int smallestArea = INT_MAX;
+        area_t smallestArea = std::numeric_limits<area_t>::max();
         for (int i = 0; i < overlapTileList.size(); i++){
             Tile* tile = overlapTileList[i];
-            int currentArea = tile->getArea();
+            area_t currentArea = tile->getArea();
             if (currentArea < smallestArea && !tileChosen[i]){
                 smallestRecIndex = i;
                 smallestArea = currentArea;
@@ -786,14 +1183,14 @@ bool DFSLegalizer::splitOverlap(MigrationEdge& edge, std::vector<Tile*>& newTile
             // for each unoccupied side of the rectangle,
             // calculate the area of the rectangle extending from B
             // keep the one with the area closest to the actual resolvableArea
-            int closestArea = -1;
+            area_t closestArea = -1;
             DIRECTION bestDirection = DIRECTION::TOP;
             Rectangle bestRectangle;
             if (!sideOccupied[0]){
                 // grow from top side
-                int width = overlapTile->getWidth();
-                int height = (int) floor((double) remainingMigrateArea / (double) width);
-                int thisArea = width * height;
+                len_t width = overlapTile->getWidth();
+                len_t height = (len_t) floor((double) remainingMigrateArea / (double) width);
+                area_t thisArea = (area_t) width * height;
                 if (thisArea > closestArea){
                     closestArea = thisArea;
                     bestDirection = DIRECTION::TOP;
@@ -805,9 +1202,9 @@ bool DFSLegalizer::splitOverlap(MigrationEdge& edge, std::vector<Tile*>& newTile
             }
             if (!sideOccupied[1]){
                 // grow from right side
-                int height = overlapTile->getHeight();
-                int width = (int) floor((double) remainingMigrateArea / (double) height);
-                int thisArea = width * height;
+                len_t height = overlapTile->getHeight();
+                len_t width = (len_t) floor((double) remainingMigrateArea / (double) height);
+                area_t thisArea = (area_t) width * height;
                 if (thisArea > closestArea){
                     closestArea = thisArea;
                     bestDirection = DIRECTION::RIGHT;
@@ -819,9 +1216,9 @@ bool DFSLegalizer::splitOverlap(MigrationEdge& edge, std::vector<Tile*>& newTile
             }
             if (!sideOccupied[2]){
                 // grow from bottom side
-                int width = overlapTile->getWidth();
-                int height = (int) floor((double) remainingMigrateArea / (double) width);
-                int thisArea = width * height;
+                len_t width = overlapTile->getWidth();
+                len_t height = (len_t) floor((double) remainingMigrateArea / (double) width);
+                area_t thisArea = (area_t) width * height;
                 if (thisArea > closestArea){
                     closestArea = thisArea;
                     bestDirection = DIRECTION::DOWN;
@@ -833,9 +1230,9 @@ bool DFSLegalizer::splitOverlap(MigrationEdge& edge, std::vector<Tile*>& newTile
             }
             if (!sideOccupied[3]){
                 // grow from left side
-                int height = overlapTile->getHeight();
-                int width = (int) floor((double) remainingMigrateArea / (double) height);
-                int thisArea = width * height;
+                len_t height = overlapTile->getHeight();
+                len_t width = (len_t) floor((double) remainingMigrateArea / (double) height);
+                area_t thisArea = (area_t) width * height;
                 if (thisArea > closestArea){
                     closestArea = thisArea;
                     bestDirection = DIRECTION::LEFT;
@@ -880,8 +1277,8 @@ bool DFSLegalizer::splitOverlap(MigrationEdge& edge, std::vector<Tile*>& newTile
 
             // if exact area migration, find remainder 
             // and split old overlap tile
-            if (config.getConfigValue<bool>("ExactAreaMigration") && remainingMigrateArea > 0){
-                int height, width;
+            if (mConfig.exactAreaMigration && remainingMigrateArea > 0){
+                len_t height, width;
                 Rectangle remainderRectangle;
                 switch (bestDirection){
                 case DIRECTION::TOP:
@@ -952,7 +1349,7 @@ bool DFSLegalizer::splitSoftBlock(MigrationEdge& edge, std::vector<Tile*>& newTi
     }
 
     Rectangle migratedRect, remainderRect(0,0,0,0);
-    if (config.getConfigValue<bool>("ExactAreaMigration")){
+    if (mConfig.exactAreaMigration){
         migratedRect = getRectFromEdge(edge, true, remainderRect, false);
     }
     else {
@@ -982,6 +1379,7 @@ bool DFSLegalizer::splitSoftBlock(MigrationEdge& edge, std::vector<Tile*>& newTi
                         DFSLPrint(0, "In splitSoftBlock, tile not found in toTess\n");
                         return false;
                     }
+                    fromTess->claimTile(newTile);
                     fromTess->TileArr.push_back(newTile);
                 }
                 newTiles.push_back(newTile);
@@ -989,7 +1387,7 @@ bool DFSLegalizer::splitSoftBlock(MigrationEdge& edge, std::vector<Tile*>& newTi
         }
     }
 
-    if (gtl::area(remainderRect) > 0 && config.getConfigValue<bool>("ExactAreaMigration")){
+    if (gtl::area(remainderRect) > 0 && mConfig.exactAreaMigration){
         std::vector<Tile*> updatedTileList = mLF->softTesserae[edge.toIndex - mFixedTessNum]->TileArr;
         for (Tile* tile: updatedTileList){
             Rectangle tileRect = tile2Rectangle(tile);
@@ -1013,6 +1411,7 @@ bool DFSLegalizer::splitSoftBlock(MigrationEdge& edge, std::vector<Tile*>& newTi
                         DFSLPrint(0, "In splitSoftBlock, tile not found in toTess\n");
                         return false;
                     }
+                    fromTess->claimTile(newTile);
                     fromTess->TileArr.push_back(newTile);
                 }
                 newTiles.push_back(newTile);
@@ -1024,52 +1423,69 @@ bool DFSLegalizer::splitSoftBlock(MigrationEdge& edge, std::vector<Tile*>& newTi
 
 bool DFSLegalizer::migrateOverlap(int overlapIndex){
     mBestPath.clear();
-    mCurrentPath.clear();
     mBestCost = (double) INT_MAX;
     mMigratingArea = mAllNodes[overlapIndex].area;
 
-    DFSLPrint(3, "\nMigrating Overlap: %s\n", mAllNodes[overlapIndex].nodeName.c_str());
-    for (DFSLEdge& edge: mAllNodes[overlapIndex].edgeList){
-        dfs(edge, 0.0);
+    if (mConfig.outputLevel >= 3){
+        DFSLPrint(3, "\nMigrating Overlap: %s\n", getNodeName(overlapIndex).c_str());
+    }
+    resetEdgeCostCache();
+    long long hits = mEdgeCostHits;
+    long long misses = mEdgeCostMisses;
+    if (mConfig.pathSearchEngine == 1){
+        bestFirstSearch(overlapIndex);
+    }
+    else if (mConfig.pathSearchThreads != 1){
+        int threadNum = mConfig.pathSearchThreads;
+        if (threadNum == 0){
+            threadNum = std::max(1u, std::thread::hardware_concurrency());
+        }
+        parallelDfs(overlapIndex, threadNum);
+    }
+    else {
+        dfs(overlapIndex);
     }
     DFSLPrint(3, "Path cost: %f\n", mBestCost);
+    DFSLPrint(3, "Edge cost cache: %lld hits, %lld misses\n", mEdgeCostHits - hits, mEdgeCostMisses - misses);
 
     if (mBestPath.size() == 0){
         DFSLPrint(3, "Path not found. Layout unchanged\n");
         return false;
     }
 
-    std::ostringstream messageStream;
-    messageStream << "Path: " << mAllNodes[overlapIndex].nodeName << " ";
-    for (MigrationEdge& edge: mBestPath){
-        if (mAllNodes[edge.toIndex].nodeType == DFSLTessType::BLANK){
-            std::string direction;
-            switch (edge.segment.direction)
-            {
-            case DIRECTION::TOP:
-                direction = "above";
-                break;
-            case DIRECTION::RIGHT:
-                direction = "right of";
-                break;
-            case DIRECTION::DOWN:
-                direction = "below";
-                break;
-            case DIRECTION::LEFT:
-                direction = "left of";
-                break;
-            default:
-                direction = "error";
-                break;
+    if (mConfig.outputLevel >= 3){
+        std::ostringstream messageStream;
+        messageStream << "Path: " << getNodeName(overlapIndex) << " ";
+        for (MigrationEdge& edge: mBestPath){
+            if (mAllNodes[edge.toIndex].nodeType == DFSLTessType::BLANK){
+                std::string direction;
+                switch (edge.segment.direction)
+                {
+                case DIRECTION::TOP:
+                    direction = "above";
+                    break;
+                case DIRECTION::RIGHT:
+                    direction = "right of";
+                    break;
+                case DIRECTION::DOWN:
+                    direction = "below";
+                    break;
+                case DIRECTION::LEFT:
+                    direction = "left of";
+                    break;
+                default:
+                    direction = "error";
+                    break;
+                }
+                messageStream << "-> Whitespace " << direction << ' ' << getNodeName(edge.fromIndex) 
+                            << " (LL: " << mAllNodes[edge.toIndex].tileList[0]->getLowerLeft() << ") ";
+            }
+            else {
+                messageStream << "-> " << getNodeName(edge.toIndex) << ' ';
             }
-            messageStream << "-> Whitespace " << direction << ' ' << mAllNodes[edge.fromIndex].nodeName 
-                        << " (LL: " << mAllNodes[edge.toIndex].tileList[0]->getLowerLeft() << ") ";
-        }
-        else {
-            messageStream << "-> " << mAllNodes[edge.toIndex].nodeName << ' ';
         }
+        DFSLPrint(3, messageStream.str().c_str());
     }
-    DFSLPrint(3, messageStream.str().c_str());
 
     // go through path, find maximum resolvable area
     mResolvableArea = mMigratingArea;
@@ -1088,13 +1504,20 @@ bool DFSLegalizer::migrateOverlap(int overlapIndex){
             }
         }
     }
-    DFSLPrint(3, "Resolvable Area: %d\n", mResolvableArea);
+    DFSLPrint(3, "Resolvable Area: %lld\n", (long long) mResolvableArea);
 
     // start changing physical layout
+    mDirtyNodes.push_back(overlapIndex);
+    for (MigrationEdge& edge: mBestPath){
+        mDirtyNodes.push_back(edge.fromIndex);
+        mDirtyNodes.push_back(edge.toIndex);
+    }
     for (MigrationEdge& edge: mBestPath){
         DFSLNode& fromNode = mAllNodes[edge.fromIndex];
         DFSLNode& toNode = mAllNodes[edge.toIndex];
-        DFSLPrint(3, "* %s -> %s:\n", fromNode.nodeName.c_str(), toNode.nodeName.c_str());
+        if (mConfig.outputLevel >= 3){
+            DFSLPrint(3, "* %s -> %s:\n", getNodeName(fromNode.index).c_str(), getNodeName(toNode.index).c_str());
+        }
 
         if (fromNode.nodeType == DFSLTessType::OVERLAP && toNode.nodeType == DFSLTessType::SOFT){
             if (mResolvableArea < mMigratingArea){
@@ -1102,32 +1525,37 @@ bool DFSLegalizer::migrateOverlap(int overlapIndex){
                 std::vector<Tile*> newTiles;
                 bool result = splitOverlap(edge, newTiles);
 
-                DFSLPrint(3, "Overlap not completely resolvable (overlap area: %d, resolvable area: %d)\n", mMigratingArea, mResolvableArea);
+                DFSLPrint(3, "Overlap not completely resolvable (overlap area: %lld, resolvable area: %lld)\n", (long long) mMigratingArea, (long long) mResolvableArea);
                 if (result){
-                    std::ostringstream messageStream;
-
-                    int actualAreaCount = 0;
+                    area_t actualAreaCount = 0;
                     for (Tile* tile: newTiles){
-                        messageStream << "\t" << *tile << '\n';
                         actualAreaCount += tile->getArea();
                     }
-                    if (actualAreaCount != mResolvableArea && config.getConfigValue<bool>("ExactAreaMigration")){
-                        DFSLPrint(1, "Migration area mismatch (actual: %d)\n", actualAreaCount);
+                    if (actualAreaCount != mResolvableArea && mConfig.exactAreaMigration){
+                        DFSLPrint(1, "Migration area mismatch (actual: %lld)\n", (long long) actualAreaCount);
+                    }
+                    if (mConfig.outputLevel >= 3){
+                        std::ostringstream messageStream;
+                        for (Tile* tile: newTiles){
+                            messageStream << "\t" << *tile << '\n';
+                        }
+                        DFSLPrint(3, "Splitting overlap tile. New tile: \n%s", messageStream.str().c_str());
                     }
-                    DFSLPrint(3, "Splitting overlap tile. New tile: \n%s", messageStream.str().c_str());
                 }
                 else {
                     DFSLPrint(3, "Split failed. Storing in value of remaining overlap area.\n");
                     OverlapArea tempArea;
-                    tempArea.index1 = *(fromNode.overlaps.begin());
-                    tempArea.index2 = *(fromNode.overlaps.rbegin());
+                    tempArea.index1 = fromNode.overlaps.front();
+                    tempArea.index2 = fromNode.overlaps.back();
                     tempArea.area = mMigratingArea - mResolvableArea;
 
                     mTransientOverlapArea.push_back(tempArea);
                 }
             }
             else {
-                DFSLPrint(3, "Removing %s attribute from %d tiles\n", toNode.nodeName.c_str(), fromNode.tileList.size());
+                if (mConfig.outputLevel >= 3){
+                    DFSLPrint(3, "Removing %s attribute from %d tiles\n", getNodeName(toNode.index).c_str(), fromNode.tileList.size());
+                }
                 int indexToRemove = edge.toIndex; // should be soft index
                 for (Tile* overlapTile: fromNode.tileList){
                     removeIndexFromOverlap(indexToRemove, overlapTile);
@@ -1136,28 +1564,31 @@ bool DFSLegalizer::migrateOverlap(int overlapIndex){
         }
         else if (fromNode.nodeType == DFSLTessType::SOFT && toNode.nodeType == DFSLTessType::SOFT){
             if (edge.segment.direction == DIRECTION::NONE) {
-                DFSLPrint(0, "BB edge ( %s -> %s ) must have DIRECTION\n", fromNode.nodeName.c_str(), toNode.nodeName.c_str());
+                DFSLPrint(0, "BB edge ( %s -> %s ) must have DIRECTION\n", getNodeName(fromNode.index).c_str(), getNodeName(toNode.index).c_str());
                 return false;
             }
 
             std::vector<Tile*> newTiles;
             bool result = splitSoftBlock(edge, newTiles);
             if (!result){
-                DFSLPrint(0, "BB flow ( %s -> %s ) FAILED.\n", fromNode.nodeName.c_str(), toNode.nodeName.c_str());
+                DFSLPrint(0, "BB flow ( %s -> %s ) FAILED.\n", getNodeName(fromNode.index).c_str(), getNodeName(toNode.index).c_str());
                 return false;
             }
             else {
-                std::ostringstream messageStream;
-
-                int actualAreaCount = 0;
+                area_t actualAreaCount = 0;
                 for (Tile* tile: newTiles){
-                    messageStream << "\t" << *tile << '\n';
                     actualAreaCount += tile->getArea();
                 }
-                if (actualAreaCount != mResolvableArea && config.getConfigValue<bool>("ExactAreaMigration")){
-                    DFSLPrint(1, "Migration area mismatch (actual: %d)\n", actualAreaCount);
+                if (actualAreaCount != mResolvableArea && mConfig.exactAreaMigration){
+                    DFSLPrint(1, "Migration area mismatch (actual: %lld)\n", (long long) actualAreaCount);
+                }
+                if (mConfig.outputLevel >= 3){
+                    std::ostringstream messageStream;
+                    for (Tile* tile: newTiles){
+                        messageStream << "\t" << *tile << '\n';
+                    }
+                    DFSLPrint(3, "Splitting tiles. New %s tile: \n%s", getNodeName(fromNode.index).c_str(), messageStream.str().c_str());
                 }
-                DFSLPrint(3, "Splitting tiles. New %s tile: \n%s", fromNode.nodeName.c_str(), messageStream.str().c_str());
             }
 
         }
@@ -1165,33 +1596,37 @@ bool DFSLegalizer::migrateOverlap(int overlapIndex){
             if (edge.segment.direction == DIRECTION::NONE) {
                 std::ostringstream messageStream;
                 messageStream << toNode.tileList[0]->getLowerLeft();
-                DFSLPrint(0, "BW edge ( %s -> %s ) must have DIRECTION\n", fromNode.nodeName.c_str(), messageStream.str().c_str());
+                DFSLPrint(0, "BW edge ( %s -> %s ) must have DIRECTION\n", getNodeName(fromNode.index).c_str(), messageStream.str().c_str());
                 return false;
             }
             
             std::vector<Tile*> newTiles;
             bool result = placeInBlank(edge, newTiles);
             if (!result){
-                DFSLPrint(0, "BW flow ( %s -> %s ) FAILED.\n", fromNode.nodeName.c_str(), toNode.nodeName.c_str());
+                DFSLPrint(0, "BW flow ( %s -> %s ) FAILED.\n", getNodeName(fromNode.index).c_str(), getNodeName(toNode.index).c_str());
                 return false;
             }
             else {
-                std::ostringstream messageStream;
-                int actualAreaCount = 0;
+                area_t actualAreaCount = 0;
                 for (Tile* tile: newTiles){
-                    messageStream << "\t" << *tile << '\n';
                     actualAreaCount += tile->getArea();
                 }
-                if (actualAreaCount != mResolvableArea && config.getConfigValue<bool>("ExactAreaMigration")){
-                    DFSLPrint(1, "Migration area mismatch (actual: %d)\n", actualAreaCount);
+                if (actualAreaCount != mResolvableArea && mConfig.exactAreaMigration){
+                    DFSLPrint(1, "Migration area mismatch (actual: %lld)\n", (long long) actualAreaCount);
+                }
+                if (mConfig.outputLevel >= 3){
+                    std::ostringstream messageStream;
+                    for (Tile* tile: newTiles){
+                        messageStream << "\t" << *tile << '\n';
+                    }
+                    DFSLPrint(3, "Placing tiles. New %s tiles: \n%s", getNodeName(fromNode.index).c_str(), messageStream.str().c_str());
                 }
-                DFSLPrint(3, "Placing tiles. New %s tiles: \n%s", fromNode.nodeName.c_str(), messageStream.str().c_str());
             }
 
         }
             // todo: deal with white -> white
         else {
-            DFSLPrint(1, "Doing nothing for migrating path: %s -> %s\n", fromNode.nodeName.c_str(),  toNode.nodeName.c_str());
+            DFSLPrint(1, "Doing nothing for migrating path: %s -> %s\n", getNodeName(fromNode.index).c_str(),  getNodeName(toNode.index).c_str());
         }
     }
 
@@ -1205,7 +1640,7 @@ bool DFSLegalizer::placeInBlank(MigrationEdge& edge, std::vector<Tile*>& newTile
     Tessera* blockTess = mLF->softTesserae[fromNode.index - mFixedTessNum]; 
 
     Rectangle newRect, remainderRect(0,0,0,0);
-    if (config.getConfigValue<bool>("ExactAreaMigration")){
+    if (mConfig.exactAreaMigration){
         newRect = getRectFromEdge(edge, true, remainderRect, false);
     }
     else {
@@ -1213,24 +1648,26 @@ bool DFSLegalizer::placeInBlank(MigrationEdge& edge, std::vector<Tile*>& newTile
     }
 
     if (gtl::area(newRect) > 0){
-        Tile* newTile = new Tile(tileType::BLOCK, Cord(gtl::xl(newRect), gtl::yl(newRect)),
+        Tile* newTile = mLF->allocateTile(tileType::BLOCK, Cord(gtl::xl(newRect), gtl::yl(newRect)),
                                     gtl::delta(newRect, gtl::orientation_2d_enum::HORIZONTAL), 
                                     gtl::delta(newRect, gtl::orientation_2d_enum::VERTICAL));
 
         // add to tess, place in physical layout
         newTiles.push_back(newTile);
+        blockTess->claimTile(newTile);
         blockTess->TileArr.push_back(newTile);
 
         mLF->insertTile(*newTile);
     }
 
-    if (config.getConfigValue<bool>("ExactAreaMigration") && gtl::area(remainderRect) > 0){
-        Tile* remainderTile = new Tile(tileType::BLOCK, Cord(gtl::xl(remainderRect), gtl::yl(remainderRect)),
+    if (mConfig.exactAreaMigration && gtl::area(remainderRect) > 0){
+        Tile* remainderTile = mLF->allocateTile(tileType::BLOCK, Cord(gtl::xl(remainderRect), gtl::yl(remainderRect)),
                             gtl::delta(remainderRect, gtl::orientation_2d_enum::HORIZONTAL), 
                             gtl::delta(remainderRect, gtl::orientation_2d_enum::VERTICAL));
 
         // add to tess, place in physical layout
         newTiles.push_back(remainderTile);
+        blockTess->claimTile(remainderTile);
         blockTess->TileArr.push_back(remainderTile);
 
         mLF->insertTile(*remainderTile);
@@ -1266,7 +1703,9 @@ void DFSLegalizer::removeIndexFromOverlap(int indexToRemove, Tile* overlapTile){
         overlapTile->setType(tileType::BLOCK);
 
         Tessera* otherTess = otherIndex < mFixedTessNum ? mLF->fixedTesserae[otherIndex] : mLF->softTesserae[otherIndex - mFixedTessNum];
+        mDirtyNodes.push_back(otherIndex);
         removeFromVector(overlapTile, otherTess->OverlapArr);
+        otherTess->claimTile(overlapTile);
         otherTess->TileArr.push_back(overlapTile);
 
         removeFromVector(overlapTile, mLF->softTesserae[indexToRemove - mFixedTessNum]->OverlapArr);
@@ -1297,40 +1736,451 @@ bool removeFromVector(Tile* a, std::vector<Tile*>& vec){
     return false;
 }
 
-void DFSLegalizer::dfs(DFSLEdge& edge, double currentCost){
-    int toIndex = edge.toIndex;
-    MigrationEdge edgeResult = getEdgeCost(edge);
-    double edgeCost = edgeResult.edgeCost;
-    currentCost += edgeCost;
-    mCurrentPath.push_back(edgeResult);
-    int blankStart = mFixedTessNum + mSoftTessNum + mOverlapNum;
-    int blankEnd = blankStart + mBlankNum;
-    if (blankStart <= toIndex && toIndex < blankEnd){
-        if (currentCost < mBestCost){
-            mBestPath = mCurrentPath;
-            mBestCost = currentCost;
+void DFSLegalizer::dfs(int overlapIndex){
+    if (mSearchStates.empty()){
+        mSearchStates.resize(1);
+    }
+    mBestCost = searchPaths(mSearchStates[0], overlapIndex, std::vector<int>(), mBestPath, nullptr);
+}
+
+double DFSLegalizer::searchPaths(PathSearchState& state, int overlapIndex, const std::vector<int>& prefix, 
+                                std::vector<MigrationEdge>& bestPath, std::atomic<double>* sharedBestCost){
+    double maxCostCutoff = mConfig.maxCostCutoff;
+    int nodeNum = mAllNodes.size();
+    bool parallel = sharedBestCost != nullptr;
+    // subtrees can only be dropped for the best cost found so far if no edge ahead can lower the path cost again,
+    // else the cutoff alone bounds the search and the merged result stays the one of dfs()
+    bool pruneByBest = parallel && mConfig.bbEdgeCostFloor() >= 0.0 && mConfig.bwEdgeCostFloor() >= 0.0;
+
+    // a path never repeats a node, so at most nodeNum records are on the stack and as many more pinned by the best path
+    int arenaSize = 2 * nodeNum;
+    if (state.pathArena.size() < arenaSize){
+        state.pathArena.resize(arenaSize);
+    }
+    state.freeRecords.clear();
+    for (int record = arenaSize - 1; record >= 0; record--){
+        state.freeRecords.push_back(record);
+    }
+    state.onPath.assign(nodeNum, false);
+    state.searchStack.clear();
+    state.searchStack.reserve(nodeNum + 1);
+    std::vector<PathRecord>& pathArena = state.pathArena;
+    int bestLeaf = -1;
+    double bestCost = (double) INT_MAX;
+
+    // a record is referenced by its stack frame, its children and by bestLeaf; unreferenced records are recycled
+    auto releaseRecord = [&](int record){
+        while (record != -1 && --pathArena[record].refs == 0){
+            state.freeRecords.push_back(record);
+            record = pathArena[record].parent;
         }
+    };
+    auto newRecord = [&](const MigrationEdge& edge, int parent){
+        assert(!state.freeRecords.empty());
+        int record = state.freeRecords.back();
+        state.freeRecords.pop_back();
+        pathArena[record].edge = edge;
+        pathArena[record].parent = parent;
+        pathArena[record].refs = 1;
+        if (parent != -1){
+            pathArena[parent].refs++;
+        }
+        return record;
+    };
+    auto checkBlank = [&](int toIndex, int record, double currentCost){
+        if (mAllNodes[toIndex].nodeType == DFSLTessType::BLANK && currentCost < bestCost){
+            if (bestLeaf != -1){
+                releaseRecord(bestLeaf);
+            }
+            bestLeaf = record;
+            pathArena[record].refs++;
+            bestCost = currentCost;
+            if (parallel){
+                double shared = sharedBestCost->load();
+                while (currentCost < shared && !sharedBestCost->compare_exchange_weak(shared, currentCost));
+            }
+        }
+    };
+
+    // the prefix (edge cost slots from the overlap node) is walked as is, its nodes are never expanded again.
+    // Only the node at its end is searched
+    state.onPath[overlapIndex] = true;
+    state.searchStack.push_back({overlapIndex, -1, prefix.empty() ? 0 : (int) mAllNodes[overlapIndex].edgeList.size(), 0.0});
+    for (int p = 0; p < prefix.size(); p++){
+        SearchFrame& frame = state.searchStack.back();
+        const MigrationEdge& edge = mEdgeCostCache[prefix[p]].result;
+        int record = newRecord(edge, frame.record);
+        double currentCost = frame.cost + edge.edgeCost;
+        bool last = p == prefix.size() - 1;
+        if (last){
+            checkBlank(edge.toIndex, record, currentCost);
+        }
+        state.onPath[edge.toIndex] = true;
+        state.searchStack.push_back({edge.toIndex, record, last ? 0 : (int) mAllNodes[edge.toIndex].edgeList.size(), currentCost});
     }
 
-    if (currentCost < config.getConfigValue<double>("MaxCostCutoff")){
-        for (DFSLEdge& nextEdge: mAllNodes[toIndex].edgeList){
-            bool skip = false;
-            for (MigrationEdge& edge: mCurrentPath){
-                if (edge.fromIndex == nextEdge.toIndex || edge.toIndex == nextEdge.toIndex) {
-                    skip = true;
-                    break;
+    while (!state.searchStack.empty()){
+        SearchFrame& frame = state.searchStack.back();
+        std::vector<DFSLEdge>& edgeList = mAllNodes[frame.nodeIndex].edgeList;
+        // the overlap node is always expanded, other nodes only below the cutoff
+        if (frame.nextEdge == edgeList.size() || (frame.record != -1 && frame.cost >= maxCostCutoff)){
+            state.onPath[frame.nodeIndex] = false;
+            if (frame.record != -1){
+                releaseRecord(frame.record);
+            }
+            state.searchStack.pop_back();
+            continue;
+        }
+
+        int position = frame.nextEdge++;
+        DFSLEdge& edge = edgeList[position];
+        int toIndex = edge.toIndex;
+        if (state.onPath[toIndex]){
+            continue;
+        }
+
+        const MigrationEdge* edgeResult;
+        if (parallel){
+            // nodes that cannot reach whitespace never hold a path
+            if (mWhitespaceBound[toIndex] == std::numeric_limits<double>::infinity()){
+                continue;
+            }
+            edgeResult = &getSharedEdgeCost(edge, mEdgeCostOffset[frame.nodeIndex] + position, state);
+            // strict comparison: paths as good as the best one found by any thread are kept, so ties still go to the
+            // path that comes first in dfs order
+            if (pruneByBest && frame.cost + edgeResult->edgeCost + mWhitespaceBound[toIndex] > sharedBestCost->load() + EPSILON){
+                continue;
+            }
+        }
+        else {
+            edgeResult = &getCachedEdgeCost(edge);
+        }
+
+        int record = newRecord(*edgeResult, frame.record);
+        double currentCost = frame.cost + edgeResult->edgeCost;
+        checkBlank(toIndex, record, currentCost);
+
+        state.onPath[toIndex] = true;
+        state.searchStack.push_back({toIndex, record, 0, currentCost});
+    }
+
+    for (int record = bestLeaf; record != -1; record = pathArena[record].parent){
+        bestPath.push_back(pathArena[record].edge);
+    }
+    std::reverse(bestPath.begin(), bestPath.end());
+    return bestCost;
+}
+
+const MigrationEdge& DFSLegalizer::getSharedEdgeCost(DFSLEdge& edge, int slot, PathSearchState& state){
+    std::atomic<EdgeCostClaim>& claim = mEdgeCostClaims[slot];
+    EdgeCostClaim expected = claim.load(std::memory_order_acquire);
+    if (expected == EdgeCostClaim::READY){
+        state.hits++;
+        return mEdgeCostCache[slot].result;
+    }
+
+    state.misses++;
+    if (expected == EdgeCostClaim::EMPTY && claim.compare_exchange_strong(expected, EdgeCostClaim::FILLING, std::memory_order_acquire)){
+        EdgeCostEntry& entry = mEdgeCostCache[slot];
+        entry.result = getEdgeCost(edge);
+        entry.stamp = mEdgeCostStamp;
+        entry.fromVersion = mAllNodes[edge.fromIndex].version;
+        entry.toVersion = mAllNodes[edge.toIndex].version;
+        claim.store(EdgeCostClaim::READY, std::memory_order_release);
+        return entry.result;
+    }
+    state.scratch = getEdgeCost(edge);
+    return state.scratch;
+}
+
+void DFSLegalizer::parallelDfs(int overlapIndex, int threadNum){
+    if (mWhitespaceBound.size() != mAllNodes.size()){
+        computeWhitespaceBound();
+    }
+    // getEdgeCost() only reads the graph once the LegalInfo of both end nodes is in place,
+    // fill it in for every node the threads can reach
+    std::vector<bool> reached(mAllNodes.size(), false);
+    std::vector<int> queue(1, overlapIndex);
+    reached[overlapIndex] = true;
+    for (int head = 0; head < queue.size(); head++){
+        getNodeLegalInfo(queue[head]);
+        for (DFSLEdge& edge: mAllNodes[queue[head]].edgeList){
+            if (!reached[edge.toIndex] && mWhitespaceBound[edge.toIndex] != std::numeric_limits<double>::infinity()){
+                reached[edge.toIndex] = true;
+                queue.push_back(edge.toIndex);
+            }
+        }
+    }
+
+    // split the search into subtrees: tasks are path prefixes, kept in dfs order. A prefix is replaced by its
+    // extensions until there are enough tasks, so the first best path of the first best task is the one dfs() picks
+    std::vector<std::vector<int>> tasks(1);
+    std::vector<double> taskCost(1, 0.0);
+    int taskTarget = threadNum * PARALLEL_TASKS_PER_THREAD;
+    bool expanded = true;
+    while (expanded && tasks.size() < taskTarget){
+        expanded = false;
+        std::vector<std::vector<int>> nextTasks;
+        std::vector<double> nextCost;
+        for (int t = 0; t < tasks.size(); t++){
+            std::vector<int>& prefix = tasks[t];
+            int endIndex = prefix.empty() ? overlapIndex : mEdgeCostCache[prefix.back()].result.toIndex;
+            if (mAllNodes[endIndex].nodeType == DFSLTessType::BLANK || (!prefix.empty() && taskCost[t] >= mConfig.maxCostCutoff)){
+                nextTasks.push_back(std::move(prefix));
+                nextCost.push_back(taskCost[t]);
+                continue;
+            }
+            expanded = true;
+            std::vector<DFSLEdge>& edgeList = mAllNodes[endIndex].edgeList;
+            for (int position = 0; position < edgeList.size(); position++){
+                int toIndex = edgeList[position].toIndex;
+                bool onPath = toIndex == overlapIndex;
+                for (int slot: prefix){
+                    onPath |= mEdgeCostCache[slot].result.toIndex == toIndex;
+                }
+                if (onPath || mWhitespaceBound[toIndex] == std::numeric_limits<double>::infinity()){
+                    continue;
+                }
+                int slot = mEdgeCostOffset[endIndex] + position;
+                nextTasks.push_back(prefix);
+                nextTasks.back().push_back(slot);
+                nextCost.push_back(taskCost[t] + getCachedEdgeCost(edgeList[position]).edgeCost);
+            }
+        }
+        tasks.swap(nextTasks);
+        taskCost.swap(nextCost);
+    }
+
+    // work stealing: every thread owns a contiguous run of tasks and takes from its front,
+    // idle threads steal from the back of the others
+    int taskNum = tasks.size();
+    threadNum = std::max(1, std::min(threadNum, taskNum));
+    if (mSearchStates.size() < threadNum){
+        mSearchStates.resize(threadNum);
+    }
+    // slots costed while splitting are ready, the threads cost the others on first use
+    int slotNum = mEdgeCostOffset.back();
+    if (mEdgeCostClaims.size() < slotNum){
+        mEdgeCostClaims = std::vector<std::atomic<EdgeCostClaim>>(slotNum);
+    }
+    for (int i = 0; i < mAllNodes.size(); i++){
+        for (int slot = mEdgeCostOffset[i]; slot < mEdgeCostOffset[i+1]; slot++){
+            const EdgeCostEntry& entry = mEdgeCostCache[slot];
+            bool ready = entry.stamp == mEdgeCostStamp && entry.fromVersion == mAllNodes[i].version
+                        && entry.toVersion == mAllNodes[mAllNodes[i].edgeList[slot - mEdgeCostOffset[i]].toIndex].version;
+            mEdgeCostClaims[slot].store(ready ? EdgeCostClaim::READY : EdgeCostClaim::EMPTY, std::memory_order_relaxed);
+        }
+    }
+    std::vector<TaskQueue> queues(threadNum);
+    for (int q = 0; q < threadNum; q++){
+        for (int t = (long long) q * taskNum / threadNum; t < (long long) (q + 1) * taskNum / threadNum; t++){
+            queues[q].tasks.push_back(t);
+        }
+    }
+    std::vector<double> resultCost(taskNum, (double) INT_MAX);
+    std::vector<std::vector<MigrationEdge>> resultPath(taskNum);
+    std::atomic<double> sharedBestCost((double) INT_MAX);
+    auto work = [&](int q){
+        PathSearchState& state = mSearchStates[q];
+        state.hits = 0;
+        state.misses = 0;
+        while (true){
+            int task = -1;
+            for (int k = 0; k < threadNum && task == -1; k++){
+                TaskQueue& queue = queues[(q + k) % threadNum];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.tasks.empty()){
+                    if (k == 0){
+                        task = queue.tasks.front();
+                        queue.tasks.pop_front();
+                    }
+                    else {
+                        task = queue.tasks.back();
+                        queue.tasks.pop_back();
+                    }
                 }
             }
-            if (skip){
+            if (task == -1){
+                break;
+            }
+            resultCost[task] = searchPaths(state, overlapIndex, tasks[task], resultPath[task], &sharedBestCost);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int q = 1; q < threadNum; q++){
+        workers.emplace_back(work, q);
+    }
+    work(0);
+    for (std::thread& worker: workers){
+        worker.join();
+    }
+
+    for (int q = 0; q < threadNum; q++){
+        mEdgeCostHits += mSearchStates[q].hits;
+        mEdgeCostMisses += mSearchStates[q].misses;
+    }
+    for (int t = 0; t < taskNum; t++){
+        if (resultCost[t] < mBestCost){
+            mBestCost = resultCost[t];
+            mBestPath.swap(resultPath[t]);
+        }
+    }
+}
+
+void DFSLegalizer::computeWhitespaceBound(){
+    double infinity = std::numeric_limits<double>::infinity();
+    double bbFloor = mConfig.bbEdgeCostFloor();
+    double bwFloor = mConfig.bwEdgeCostFloor();
+    // negative floors would reward longer paths, the bound falls back to 0 for those and only marks dead ends
+    bbFloor = std::max(0.0, bbFloor);
+    bwFloor = std::max(0.0, bwFloor);
+
+    // hop count to the nearest whitespace, bfs over reversed edges starting at every blank node
+    int nodeNum = mAllNodes.size();
+    std::vector<int> hops(nodeNum, -1);
+    std::vector<int> queue;
+    for (int i = 0; i < nodeNum; i++){
+        if (mAllNodes[i].nodeType == DFSLTessType::BLANK){
+            hops[i] = 0;
+            queue.push_back(i);
+        }
+    }
+    for (int head = 0; head < queue.size(); head++){
+        int current = queue[head];
+        for (int from: mAllNodes[current].predecessors){
+            if (hops[from] == -1){
+                hops[from] = hops[current] + 1;
+                queue.push_back(from);
+            }
+        }
+    }
+
+    // the last hop is a BW edge, every hop before it a BB edge
+    mWhitespaceBound.assign(nodeNum, infinity);
+    for (int i = 0; i < nodeNum; i++){
+        if (hops[i] == 0){
+            mWhitespaceBound[i] = 0.0;
+        }
+        else if (hops[i] > 0){
+            mWhitespaceBound[i] = bwFloor + (hops[i] - 1) * bbFloor;
+        }
+    }
+}
+
+void DFSLegalizer::bestFirstSearch(int overlapIndex){
+    if (mWhitespaceBound.size() != mAllNodes.size()){
+        computeWhitespaceBound();
+    }
+
+    double maxCostCutoff = mConfig.maxCostCutoff;
+    int nodeNum = mAllNodes.size();
+    std::vector<double> pathCost(nodeNum, std::numeric_limits<double>::infinity());
+    std::vector<MigrationEdge> pathEdge(nodeNum);
+    std::vector<bool> settled(nodeNum, false);
+
+    // (cost so far + bound to whitespace, node index), ties go to the smaller index
+    typedef std::pair<double, int> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openList;
+    pathCost[overlapIndex] = 0.0;
+    openList.push(QueueEntry(0.0, overlapIndex));
+
+    while (!openList.empty()){
+        int current = openList.top().second;
+        openList.pop();
+        if (settled[current]){
+            continue;
+        }
+        settled[current] = true;
+
+        if (mAllNodes[current].nodeType == DFSLTessType::BLANK){
+            // every node on the path was settled before its successor, so the path is simple
+            mBestCost = pathCost[current];
+            for (int node = current; node != overlapIndex; node = pathEdge[node].fromIndex){
+                mBestPath.push_back(pathEdge[node]);
+            }
+            std::reverse(mBestPath.begin(), mBestPath.end());
+            return;
+        }
+
+        if (pathCost[current] >= maxCostCutoff){
+            continue;
+        }
+        for (DFSLEdge& edge: mAllNodes[current].edgeList){
+            int toIndex = edge.toIndex;
+            if (settled[toIndex] || mWhitespaceBound[toIndex] == std::numeric_limits<double>::infinity()){
                 continue;
             }
-            else {
-                dfs(nextEdge, currentCost);
+            const MigrationEdge& edgeResult = getCachedEdgeCost(edge);
+            double cost = pathCost[current] + edgeResult.edgeCost;
+            if (cost < pathCost[toIndex]){
+                pathCost[toIndex] = cost;
+                pathEdge[toIndex] = edgeResult;
+                openList.push(QueueEntry(cost + mWhitespaceBound[toIndex], toIndex));
             }
         }
     }
+}
+
+void DFSLegalizer::resetEdgeCostCache(){
+    // slots are numbered edge by edge, node by node
+    mEdgeCostOffset.resize(mAllNodes.size() + 1);
+    mEdgeCostOffset[0] = 0;
+    for (int i = 0; i < mAllNodes.size(); i++){
+        mEdgeCostOffset[i+1] = mEdgeCostOffset[i] + mAllNodes[i].edgeList.size();
+    }
+    if (mEdgeCostCache.size() < mEdgeCostOffset.back()){
+        mEdgeCostCache.resize(mEdgeCostOffset.back());
+    }
+
+    ++mEdgeCostStamp;
+    if (mEdgeCostStamp == 0){
+        // the stamp wrapped around, stale entries could look current again
+        for (EdgeCostEntry& entry: mEdgeCostCache){
+            entry.stamp = 0;
+        }
+        mEdgeCostStamp = 1;
+    }
+}
+
+const MigrationEdge& DFSLegalizer::getCachedEdgeCost(DFSLEdge& edge){
+    DFSLNode& fromNode = mAllNodes[edge.fromIndex];
+    DFSLNode& toNode = mAllNodes[edge.toIndex];
+    int position = &edge - fromNode.edgeList.data();
+    assert(0 <= position && position < fromNode.edgeList.size());
+
+    EdgeCostEntry& entry = mEdgeCostCache[mEdgeCostOffset[edge.fromIndex] + position];
+    if (entry.stamp == mEdgeCostStamp && entry.fromVersion == fromNode.version && entry.toVersion == toNode.version){
+        mEdgeCostHits++;
+        return entry.result;
+    }
+
+    mEdgeCostMisses++;
+    entry.result = getEdgeCost(edge);
+    entry.stamp = mEdgeCostStamp;
+    entry.fromVersion = fromNode.version;
+    entry.toVersion = toNode.version;
+    return entry.result;
+}
+
+const LegalInfo& DFSLegalizer::getNodeLegalInfo(int nodeIndex){
+    DFSLNode& node = mAllNodes[nodeIndex];
+    if (mNodeLegalInfo.size() < mAllNodes.size()){
+        mNodeLegalInfo.resize(mAllNodes.size());
+    }
+    NodeLegalInfo& entry = mNodeLegalInfo[nodeIndex];
+    if (entry.version != node.version){
+        entry.info = getLegalInfo(node.tileList);
+        entry.version = node.version;
+    }
+    return entry.info;
+}
+
+long long DFSLegalizer::getEdgeCostCacheHits() const {
+    return mEdgeCostHits;
+}
 
-    mCurrentPath.pop_back();
+long long DFSLegalizer::getEdgeCostCacheMisses() const {
+    return mEdgeCostMisses;
 }
 
 MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
@@ -1365,45 +2215,41 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
     case EDGETYPE::OB:
     {
         Tessera* toTess = mLF->softTesserae[edge.toIndex - mFixedTessNum];
-        std::set<Tile*> overlap;
-        std::set<Tile*> withoutOverlap;
-        std::set<Tile*> withOverlap;
-
-        for (Tile* tile: toTess->TileArr){
-            withoutOverlap.insert(tile); 
-            withOverlap.insert(tile);
-        }
-        for (Tile* tile: toTess->OverlapArr){
-            withoutOverlap.insert(tile); 
-            withOverlap.insert(tile);
-        }
-        
-        for (Tile* tile: fromNode.tileList){
-            overlap.insert(tile);
-            withoutOverlap.erase(tile);
+        const LegalInfo& overlapInfo = getNodeLegalInfo(edge.fromIndex);
+        // the tessera with and without the tiles of this overlap node
+        LegalInfoBuilder withOverlapBuilder, withoutOverlapBuilder;
+        for (std::vector<Tile*>* tileArr: {&toTess->TileArr, &toTess->OverlapArr}){
+            for (Tile* tile: *tileArr){
+                withOverlapBuilder.add(tile);
+                bool inOverlap = false;
+                for (int nodeIndex: mTilePtr2NodeIndex.find(tile)){
+                    inOverlap |= nodeIndex == edge.fromIndex;
+                }
+                if (!inOverlap){
+                    withoutOverlapBuilder.add(tile);
+                }
+            }
         }
-
-        LegalInfo overlapInfo = getLegalInfo(overlap);
-        LegalInfo withOverlapInfo = getLegalInfo(withOverlap);
-        LegalInfo withoutOverlapInfo = getLegalInfo(withoutOverlap);
+        LegalInfo withOverlapInfo = withOverlapBuilder.getLegalInfo();
+        LegalInfo withoutOverlapInfo = withoutOverlapBuilder.getLegalInfo();
 
         // get area
         double overlapArea = overlapInfo.actualArea;
         double blockArea = withoutOverlapInfo.actualArea;
-        double areaWeight = (overlapArea / blockArea) * config.getConfigValue<double>("OBAreaWeight");
+        double areaWeight = (overlapArea / blockArea) * mConfig.obAreaWeight;
 
         // get util
         double withOverlapUtil = withOverlapInfo.util;
         double withoutOverlapUtil = withoutOverlapInfo.util;
         // positive reinforcement if util is improved
-        double utilCost = (withOverlapUtil < withoutOverlapUtil) ? (withoutOverlapUtil - withOverlapUtil) * config.getConfigValue<double>("OBUtilPosRein") :  
-                                                        (1.0 - withoutOverlapUtil) * config.getConfigValue<double>("OBUtilWeight");
+        double utilCost = (withOverlapUtil < withoutOverlapUtil) ? (withoutOverlapUtil - withOverlapUtil) * mConfig.obUtilPosRein :  
+                                                        (1.0 - withoutOverlapUtil) * mConfig.obUtilWeight;
 
 
         // get value of long/short side without overlap
         double aspectRatio = withoutOverlapInfo.aspectRatio;
         aspectRatio = aspectRatio > 1.0 ? aspectRatio : 1.0/aspectRatio;
-        double aspectCost = pow(aspectRatio - 1.0, 4) * config.getConfigValue<double>("OBAspWeight");
+        double aspectCost = pow(aspectRatio - 1.0, 4) * mConfig.obAspWeight;
 
         edgeCost += areaWeight + utilCost + aspectCost;
 
@@ -1412,13 +2258,11 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
 
     case EDGETYPE::BB:
     {
-        Polygon90Set fromBlock, toBlock;
-        fromBlock.clear();
-        toBlock.clear();
-        TileVec2PolySet(fromNode.tileList, fromBlock);
+        // toBlock is only needed to find walls
+        Polygon90Set toBlock;
         TileVec2PolySet(toNode.tileList, toBlock);
-        LegalInfo oldFromBlockInfo = getLegalInfo(fromBlock);
-        LegalInfo oldToBlockInfo = getLegalInfo(toBlock);
+        const LegalInfo& oldFromBlockInfo = getNodeLegalInfo(edge.fromIndex);
+        const LegalInfo& oldToBlockInfo = getNodeLegalInfo(edge.toIndex);
 
         // predict new rectangle
         double lowestCost = (double) LONG_MAX;
@@ -1428,12 +2272,12 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             Segment seg = edge.tangentSegments[s];
             Segment wall = FindNearestOverlappingInterval(seg, toBlock);
             Cord BL;
-            int width;
-            int height;
+            len_t width;
+            len_t height;
             if (seg.direction == DIRECTION::TOP){
                 width = abs(seg.segEnd.x - seg.segStart.x); 
-                int requiredHeight = ceil((double) mMigratingArea / (double) width);
-                int availableHeight = wall.segStart.y - seg.segStart.y;
+                len_t requiredHeight = ceil((double) mMigratingArea / (double) width);
+                len_t availableHeight = wall.segStart.y - seg.segStart.y;
                 assert(availableHeight > 0);
                 height = availableHeight > requiredHeight ? requiredHeight : availableHeight;
                 BL.x = seg.segStart.x < seg.segEnd.x ? seg.segStart.x : seg.segEnd.x ;
@@ -1441,8 +2285,8 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             }
             else if (seg.direction == DIRECTION::RIGHT){
                 height = abs(seg.segEnd.y - seg.segStart.y); 
-                int requiredWidth = ceil((double) mMigratingArea / (double) height);
-                int availableWidth = wall.segStart.x - seg.segStart.x;
+                len_t requiredWidth = ceil((double) mMigratingArea / (double) height);
+                len_t availableWidth = wall.segStart.x - seg.segStart.x;
                 assert(availableWidth > 0);
                 width = availableWidth > requiredWidth ? requiredWidth : availableWidth;
                 BL.x = seg.segStart.x;
@@ -1450,8 +2294,8 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             }
             else if (seg.direction == DIRECTION::DOWN){
                 width = abs(seg.segEnd.x - seg.segStart.x); 
-                int requiredHeight = ceil((double) mMigratingArea / (double) width);
-                int availableHeight = seg.segStart.y - wall.segStart.y;
+                len_t requiredHeight = ceil((double) mMigratingArea / (double) width);
+                len_t availableHeight = seg.segStart.y - wall.segStart.y;
                 assert(availableHeight > 0);
                 height = availableHeight > requiredHeight ? requiredHeight : availableHeight;
                 BL.x = seg.segStart.x < seg.segEnd.x ? seg.segStart.x : seg.segEnd.x ;
@@ -1459,8 +2303,8 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             }
             else if (seg.direction == DIRECTION::LEFT) {
                 height = abs(seg.segEnd.y - seg.segStart.y); 
-                int requiredWidth = ceil((double) mMigratingArea / (double) height);
-                int availableWidth = seg.segStart.x - wall.segStart.x;
+                len_t requiredWidth = ceil((double) mMigratingArea / (double) height);
+                len_t availableWidth = seg.segStart.x - wall.segStart.x;
                 assert(availableWidth > 0);
                 width = availableWidth > requiredWidth ? requiredWidth : availableWidth;
                 BL.x = seg.segStart.x - width;
@@ -1469,18 +2313,15 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             else {
                 std::ostringstream messageStream;
                 messageStream << toNode.tileList[0]->getLowerLeft();
-                DFSLPrint(0, "BB edge ( %s -> %s ) has no DIRECTION\n", fromNode.nodeName.c_str(),  messageStream.str().c_str());
+                DFSLPrint(0, "BB edge ( %s -> %s ) has no DIRECTION\n", getNodeName(fromNode.index).c_str(),  messageStream.str().c_str());
             }
 
             Rectangle newArea(BL.x, BL.y, BL.x+width, BL.y+height);
-            Polygon90Set newFromBlock = fromBlock + newArea;
-            Polygon90Set newToBlock = toBlock - newArea;
-
-            LegalInfo newFromBlockInfo = getLegalInfo(newFromBlock);
-            LegalInfo newToBlockInfo = getLegalInfo(newToBlock);
+            LegalInfo newFromBlockInfo = getLegalInfoWithRect(oldFromBlockInfo, fromNode.tileList, newArea);
+            LegalInfo newToBlockInfo = getLegalInfoWithoutRect(toNode.tileList, newArea);
 
             // area cost
-            double areaCost = ((double) oldFromBlockInfo.actualArea / (double) oldToBlockInfo.actualArea) * config.getConfigValue<double>("BBAreaWeight");
+            double areaCost = ((double) oldFromBlockInfo.actualArea / (double) oldToBlockInfo.actualArea) * mConfig.bbAreaWeight;
 
             // get util
             double oldFromBlockUtil = oldFromBlockInfo.util;
@@ -1489,16 +2330,16 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             double newToBlockUtil = newToBlockInfo.util;
             // positive reinforcement if util is improved
             double utilCost, fromUtilCost, toUtilCost;
-            fromUtilCost = (oldFromBlockUtil < newFromBlockUtil) ? (newFromBlockUtil - oldFromBlockUtil) * config.getConfigValue<double>("BBFromUtilPosRein") :  
-                                                        (1.0 - newFromBlockUtil) * config.getConfigValue<double>("BBFromUtilWeight");
-            toUtilCost = (oldToBlockUtil < newToBlockUtil) ? (newToBlockUtil - oldToBlockUtil) * config.getConfigValue<double>("BBToUtilPosRein") :  
-                                                        pow(1.0 - newToBlockUtil, 2) * config.getConfigValue<double>("BBToUtilWeight");
+            fromUtilCost = (oldFromBlockUtil < newFromBlockUtil) ? (newFromBlockUtil - oldFromBlockUtil) * mConfig.bbFromUtilPosRein :  
+                                                        (1.0 - newFromBlockUtil) * mConfig.bbFromUtilWeight;
+            toUtilCost = (oldToBlockUtil < newToBlockUtil) ? (newToBlockUtil - oldToBlockUtil) * mConfig.bbToUtilPosRein :  
+                                                        pow(1.0 - newToBlockUtil, 2) * mConfig.bbToUtilWeight;
             
             // get aspect ratio with new area
             double aspectRatio = newFromBlockInfo.aspectRatio;
             aspectRatio = aspectRatio > 1.0 ? aspectRatio : 1.0/aspectRatio;
             double arCost;
-            arCost = (aspectRatio - 1.0) * config.getConfigValue<double>("BBAspWeight");
+            arCost = (aspectRatio - 1.0) * mConfig.bbAspWeight;
 
             double cost = areaCost + fromUtilCost + toUtilCost + arCost;
                             
@@ -1511,16 +2352,13 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
 
         bestSegment = edge.tangentSegments[bestSegmentIndex];
         returnRectangle = bestRectangle;
-        edgeCost += lowestCost + config.getConfigValue<double>("BBFlatCost");
+        edgeCost += lowestCost + mConfig.bbFlatCost;
 
         break;
     }
     case EDGETYPE::BW:
     {
-        Polygon90Set oldBlock;
-        TileVec2PolySet(fromNode.tileList, oldBlock);
-
-        LegalInfo oldBlockInfo = getLegalInfo(oldBlock);
+        const LegalInfo& oldBlockInfo = getNodeLegalInfo(edge.fromIndex);
 
         // predict new tile
         double lowestCost = (double) LONG_MAX;
@@ -1529,32 +2367,32 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
         for (int s = 0; s < edge.tangentSegments.size(); s++){
             Segment seg = edge.tangentSegments[s];
             Cord BL;
-            int width;
-            int height;
+            len_t width;
+            len_t height;
             if (seg.direction == DIRECTION::TOP){
                 width = abs(seg.segEnd.x - seg.segStart.x); 
-                int requiredHeight = ceil((double) mMigratingArea / (double) width);
+                len_t requiredHeight = ceil((double) mMigratingArea / (double) width);
                 height = toNode.tileList[0]->getHeight() > requiredHeight ? requiredHeight : toNode.tileList[0]->getHeight();
                 BL.x = seg.segStart.x < seg.segEnd.x ? seg.segStart.x : seg.segEnd.x ;
                 BL.y = seg.segStart.y;
             }
             else if (seg.direction == DIRECTION::RIGHT){
                 height = abs(seg.segEnd.y - seg.segStart.y); 
-                int requiredWidth = ceil((double) mMigratingArea / (double) height);
+                len_t requiredWidth = ceil((double) mMigratingArea / (double) height);
                 width = toNode.tileList[0]->getWidth() > requiredWidth ? requiredWidth : toNode.tileList[0]->getWidth();
                 BL.x = seg.segStart.x;
                 BL.y = seg.segStart.y < seg.segEnd.y ? seg.segStart.y : seg.segEnd.y ;
             }
             else if (seg.direction == DIRECTION::DOWN){
                 width = abs(seg.segEnd.x - seg.segStart.x); 
-                int requiredHeight = ceil((double) mMigratingArea / (double) width);
+                len_t requiredHeight = ceil((double) mMigratingArea / (double) width);
                 height = toNode.tileList[0]->getHeight() > requiredHeight ? requiredHeight : toNode.tileList[0]->getHeight();
                 BL.x = seg.segStart.x < seg.segEnd.x ? seg.segStart.x : seg.segEnd.x ;
                 BL.y = seg.segStart.y - height;
             }
             else if (seg.direction == DIRECTION::LEFT) {
                 height = abs(seg.segEnd.y - seg.segStart.y); 
-                int requiredWidth = ceil((double) mMigratingArea / (double) height);
+                len_t requiredWidth = ceil((double) mMigratingArea / (double) height);
                 width = toNode.tileList[0]->getWidth() > requiredWidth ? requiredWidth : toNode.tileList[0]->getWidth();
                 BL.x = seg.segStart.x - width;
                 BL.y = seg.segStart.y < seg.segEnd.y ? seg.segStart.y : seg.segEnd.y ;
@@ -1562,27 +2400,25 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
             else {
                 std::ostringstream messageStream;
                 messageStream << toNode.tileList[0]->getLowerLeft();
-                DFSLPrint(1, "BW edge ( %s -> %s ) has no DIRECTION\n", fromNode.nodeName.c_str(),  messageStream.str().c_str());
+                DFSLPrint(1, "BW edge ( %s -> %s ) has no DIRECTION\n", getNodeName(fromNode.index).c_str(),  messageStream.str().c_str());
             }
 
             Rectangle newArea(BL.x, BL.y, BL.x+width, BL.y+height);
-            Polygon90Set newBlock = oldBlock + newArea;
-
-            LegalInfo newBlockInfo = getLegalInfo(newBlock);
+            LegalInfo newBlockInfo = getLegalInfoWithRect(oldBlockInfo, fromNode.tileList, newArea);
 
             // get util
             double oldBlockUtil = oldBlockInfo.util;
             double newBlockUtil = newBlockInfo.util;
             // positive reinforcement if util is improved
             double utilCost;
-            utilCost = (oldBlockUtil < newBlockUtil) ? (newBlockUtil - oldBlockUtil) * config.getConfigValue<double>("BWUtilPosRein") :  
-                                                        (1.0 - newBlockUtil) * config.getConfigValue<double>("BWUtilWeight");
+            utilCost = (oldBlockUtil < newBlockUtil) ? (newBlockUtil - oldBlockUtil) * mConfig.bwUtilPosRein :  
+                                                        (1.0 - newBlockUtil) * mConfig.bwUtilWeight;
 
             // get aspect ratio with new area
             double aspectRatio = newBlockInfo.aspectRatio;
             aspectRatio = aspectRatio > 1.0 ? aspectRatio : 1.0/aspectRatio;
             double arCost;
-            arCost = pow(aspectRatio - 1.0, 4.0) * config.getConfigValue<double>("BWAspWeight");
+            arCost = pow(aspectRatio - 1.0, 4.0) * mConfig.bwAspWeight;
 
             double cost = utilCost + arCost;
                             
@@ -1601,11 +2437,11 @@ MigrationEdge DFSLegalizer::getEdgeCost(DFSLEdge& edge){
     }
 
     case EDGETYPE::WW:
-        edgeCost += config.getConfigValue<double>("WWFlatCost");
+        edgeCost += mConfig.wwFlatCost;
         break;
 
     default:
-        edgeCost += config.getConfigValue<double>("MaxCostCutoff") * 100;
+        edgeCost += mConfig.maxCostCutoff * 100;
         break;
     }
 
@@ -1632,7 +2468,7 @@ void TileVec2PolySet(std::vector<Tile*>& tileVec, Polygon90Set& polySet){
 Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
     int segmentOrientation; // 0 = segments are X direction, 1 = Y direction
     Segment closestSegment = seg;
-    int closestDistance = INT_MAX;
+    len_t closestDistance = std::numeric_limits<len_t>::max();
     if (seg.direction == DIRECTION::DOWN || seg.direction == DIRECTION::TOP){
         segmentOrientation = 0;
     }
@@ -1671,7 +2507,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                     bool overlaps = ((currentSegment.segStart.x < seg.segEnd.x) && (seg.segStart.x < currentSegment.segEnd.x));
                     bool isAbove = currentSegment.segStart.y > seg.segStart.y;
                     if (overlaps && isAbove){
-                        int distance = currentSegment.segStart.y - seg.segStart.y;
+                        len_t distance = currentSegment.segStart.y - seg.segStart.y;
                         if (distance < closestDistance){
                             closestDistance = distance;
                             closestSegment = currentSegment;
@@ -1685,7 +2521,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                     bool overlaps = ((currentSegment.segStart.y < seg.segEnd.y) && (seg.segStart.y < currentSegment.segEnd.y));
                     bool isRight = currentSegment.segStart.x > seg.segStart.x;
                     if (overlaps && isRight){
-                        int distance = currentSegment.segStart.x - seg.segStart.x;
+                        len_t distance = currentSegment.segStart.x - seg.segStart.x;
                         if (distance < closestDistance){
                             closestDistance = distance;
                             closestSegment = currentSegment;
@@ -1699,7 +2535,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                     bool overlaps = ((currentSegment.segStart.x < seg.segEnd.x) && (seg.segStart.x < currentSegment.segEnd.x));
                     bool isBelow = currentSegment.segStart.y < seg.segStart.y;
                     if (overlaps && isBelow){
-                        int distance = seg.segStart.y -currentSegment.segStart.y;
+                        len_t distance = seg.segStart.y -currentSegment.segStart.y;
                         if (distance < closestDistance){
                             closestDistance = distance;
                             closestSegment = currentSegment;
@@ -1713,7 +2549,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                     bool overlaps = ((currentSegment.segStart.y < seg.segEnd.y) && (seg.segStart.y < currentSegment.segEnd.y));
                     bool isLeft = currentSegment.segStart.x < seg.segStart.x;
                     if (overlaps && isLeft){
-                        int distance = seg.segStart.x - currentSegment.segStart.x;
+                        len_t distance = seg.segStart.x - currentSegment.segStart.x;
                         if (distance < closestDistance){
                             closestDistance = distance;
                             closestSegment = currentSegment;
@@ -1745,7 +2581,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                 bool overlaps = ((lastSegment.segStart.x < seg.segEnd.x) && (seg.segStart.x < lastSegment.segEnd.x));
                 bool isAbove = lastSegment.segStart.y > seg.segStart.y;
                 if (overlaps && isAbove){
-                    int distance = lastSegment.segStart.y - seg.segStart.y;
+                    len_t distance = lastSegment.segStart.y - seg.segStart.y;
                     if (distance < closestDistance){
                         closestDistance = distance;
                         closestSegment = lastSegment;
@@ -1759,7 +2595,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                 bool overlaps = ((lastSegment.segStart.y < seg.segEnd.y) && (seg.segStart.y < lastSegment.segEnd.y));
                 bool isRight = lastSegment.segStart.x > seg.segStart.x;
                 if (overlaps && isRight){
-                    int distance = lastSegment.segStart.x - seg.segStart.x;
+                    len_t distance = lastSegment.segStart.x - seg.segStart.x;
                     if (distance < closestDistance){
                         closestDistance = distance;
                         closestSegment = lastSegment;
@@ -1773,7 +2609,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                 bool overlaps = ((lastSegment.segStart.x < seg.segEnd.x) && (seg.segStart.x < lastSegment.segEnd.x));
                 bool isBelow = lastSegment.segStart.y < seg.segStart.y;
                 if (overlaps && isBelow){
-                    int distance = seg.segStart.y -lastSegment.segStart.y;
+                    len_t distance = seg.segStart.y -lastSegment.segStart.y;
                     if (distance < closestDistance){
                         closestDistance = distance;
                         closestSegment = lastSegment;
@@ -1787,7 +2623,7 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
                 bool overlaps = ((lastSegment.segStart.y < seg.segEnd.y) && (seg.segStart.y < lastSegment.segEnd.y));
                 bool isLeft = lastSegment.segStart.x < seg.segStart.x;
                 if (overlaps && isLeft){
-                    int distance = seg.segStart.x - lastSegment.segStart.x;
+                    len_t distance = seg.segStart.x - lastSegment.segStart.x;
                     if (distance < closestDistance){
                         closestDistance = distance;
                         closestSegment = lastSegment;
@@ -1806,9 +2642,9 @@ Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly){
 
 LegalInfo getLegalInfo(std::vector<Tile*>& tiles){
     LegalInfo legal;
-    int min_x, max_x, min_y, max_y;
-    min_x = min_y = INT_MAX;
-    max_x = max_y = -INT_MAX;
+    len_t min_x, max_x, min_y, max_y;
+    min_x = min_y = std::numeric_limits<len_t>::max();
+    max_x = max_y = -std::numeric_limits<len_t>::max();
     legal.actualArea = 0;
     for (Tile* tile: tiles){
         if (tile->getLowerLeft().x < min_x){
@@ -1828,7 +2664,7 @@ LegalInfo getLegalInfo(std::vector<Tile*>& tiles){
     legal.width = max_x - min_x;
     legal.height = max_y - min_y;
 
-    legal.bbArea = legal.width * legal.height; 
+    legal.bbArea = (area_t) legal.width * legal.height; 
     legal.BL = Cord(min_x, min_y);  
     if (legal.width == 0 || legal.height == 0){
         legal.aspectRatio = INT_MAX;
@@ -1848,9 +2684,9 @@ LegalInfo getLegalInfo(std::vector<Tile*>& tiles){
 
 LegalInfo getLegalInfo(std::set<Tile*>& tiles){
     LegalInfo legal;
-    int min_x, max_x, min_y, max_y;
-    min_x = min_y = INT_MAX;
-    max_x = max_y = -INT_MAX;
+    len_t min_x, max_x, min_y, max_y;
+    min_x = min_y = std::numeric_limits<len_t>::max();
+    max_x = max_y = -std::numeric_limits<len_t>::max();
     legal.actualArea = 0;
     for (Tile* tile: tiles){
         if (tile->getLowerLeft().x < min_x){
@@ -1870,7 +2706,7 @@ LegalInfo getLegalInfo(std::set<Tile*>& tiles){
     legal.width = max_x - min_x;
     legal.height = max_y - min_y;
 
-    legal.bbArea = legal.width * legal.height; 
+    legal.bbArea = (area_t) legal.width * legal.height; 
     legal.BL = Cord(min_x, min_y);  
     if (legal.width == 0 || legal.height == 0){
         legal.aspectRatio = INT_MAX;
@@ -1894,6 +2730,11 @@ LegalInfo getLegalInfo(std::set<Tile*>& tiles){
 // 3 : Verbose info
 void DFSLegalizer::setOutputLevel(DFSL_PRINTLEVEL level){
     config.setConfigValue<int>("OutputLevel",(int)level);
+    mConfig.outputLevel = level;
+}
+
+void DFSLegalizer::compileConfig(){
+    mConfig = config.compile();
 }
 
 LegalInfo getLegalInfo(Polygon90Set& tiles){
@@ -1904,7 +2745,7 @@ LegalInfo getLegalInfo(Polygon90Set& tiles){
     legal.actualArea = gtl::area(tiles);
     legal.width = gtl::delta(bbox, gtl::orientation_2d_enum::HORIZONTAL);
     legal.height = gtl::delta(bbox, gtl::orientation_2d_enum::VERTICAL);
-    legal.bbArea = legal.width * legal.height;
+    legal.bbArea = (area_t) legal.width * legal.height;
     legal.BL = Cord(gtl::xl(bbox), gtl::yl(bbox));
     if (legal.width == 0 || legal.height == 0){
         legal.aspectRatio = INT_MAX;
@@ -1922,6 +2763,107 @@ LegalInfo getLegalInfo(Polygon90Set& tiles){
     return legal;
 } 
 
+LegalInfoBuilder::LegalInfoBuilder()
+    : minX(std::numeric_limits<len_t>::max()), minY(std::numeric_limits<len_t>::max()),
+      maxX(-std::numeric_limits<len_t>::max()), maxY(-std::numeric_limits<len_t>::max()), actualArea(0) {}
+
+void LegalInfoBuilder::add(len_t xl, len_t yl, len_t xh, len_t yh, area_t area){
+    minX = std::min(minX, xl);
+    minY = std::min(minY, yl);
+    maxX = std::max(maxX, xh);
+    maxY = std::max(maxY, yh);
+    actualArea += area;
+}
+
+void LegalInfoBuilder::add(Tile* tile){
+    add(tile->getLowerLeft().x, tile->getLowerLeft().y, tile->getUpperRight().x, tile->getUpperRight().y, tile->getArea());
+}
+
+// same derived values as the getLegalInfo() overloads
+LegalInfo LegalInfoBuilder::getLegalInfo() const {
+    LegalInfo legal;
+    legal.actualArea = actualArea;
+    if (minX > maxX){
+        // nothing was added
+        legal.width = legal.height = 0;
+        legal.BL = Cord(0, 0);
+    }
+    else {
+        legal.width = maxX - minX;
+        legal.height = maxY - minY;
+        legal.BL = Cord(minX, minY);  
+    }
+    legal.bbArea = (area_t) legal.width * legal.height; 
+    if (legal.width == 0 || legal.height == 0){
+        legal.aspectRatio = INT_MAX;
+    }
+    else {
+        legal.aspectRatio = ((double) legal.width) / ((double) legal.height);
+    }
+    if (legal.actualArea == 0 || legal.bbArea == 0){
+        legal.util = 0;
+    }
+    else {
+        legal.util = ((double) legal.actualArea) / ((double) legal.bbArea);
+    }
+    return legal;
+}
+
+area_t getIntersectArea(std::vector<Tile*>& tiles, const Rectangle& rect){
+    area_t area = 0;
+    for (Tile* tile: tiles){
+        len_t width = std::min(tile->getUpperRight().x, gtl::xh(rect)) - std::max(tile->getLowerLeft().x, gtl::xl(rect));
+        len_t height = std::min(tile->getUpperRight().y, gtl::yh(rect)) - std::max(tile->getLowerLeft().y, gtl::yl(rect));
+        if (width > 0 && height > 0){
+            area += (area_t) width * height;
+        }
+    }
+    return area;
+}
+
+LegalInfo getLegalInfoWithRect(const LegalInfo& info, std::vector<Tile*>& tiles, const Rectangle& rect){
+    if (gtl::delta(rect, gtl::orientation_2d_enum::HORIZONTAL) <= 0 || gtl::delta(rect, gtl::orientation_2d_enum::VERTICAL) <= 0){
+        return info;
+    }
+    LegalInfoBuilder builder;
+    builder.add(info.BL.x, info.BL.y, info.BL.x + info.width, info.BL.y + info.height, info.actualArea);
+    builder.add(gtl::xl(rect), gtl::yl(rect), gtl::xh(rect), gtl::yh(rect), gtl::area(rect) - getIntersectArea(tiles, rect));
+    return builder.getLegalInfo();
+}
+
+LegalInfo getLegalInfoWithoutRect(std::vector<Tile*>& tiles, const Rectangle& rect){
+    // the bounding box may shrink, so it is rebuilt from what is left of each tile:
+    // the parts left and right of rect (full height), and below and above it (within its x span)
+    LegalInfoBuilder builder;
+    for (Tile* tile: tiles){
+        len_t xl = tile->getLowerLeft().x;
+        len_t yl = tile->getLowerLeft().y;
+        len_t xh = tile->getUpperRight().x;
+        len_t yh = tile->getUpperRight().y;
+        len_t cutXl = std::max(xl, gtl::xl(rect));
+        len_t cutXh = std::min(xh, gtl::xh(rect));
+        len_t cutYl = std::max(yl, gtl::yl(rect));
+        len_t cutYh = std::min(yh, gtl::yh(rect));
+        if (cutXl >= cutXh || cutYl >= cutYh){
+            builder.add(tile);
+            continue;
+        }
+        if (xl < cutXl){
+            builder.add(xl, yl, cutXl, yh, (area_t) (cutXl - xl) * (yh - yl));
+        }
+        if (cutXh < xh){
+            builder.add(cutXh, yl, xh, yh, (area_t) (xh - cutXh) * (yh - yl));
+        }
+        if (yl < cutYl){
+            builder.add(cutXl, yl, cutXh, cutYl, (area_t) (cutXh - cutXl) * (cutYl - yl));
+        }
+        if (cutYh < yh){
+            builder.add(cutXl, cutYh, cutXh, yh, (area_t) (cutXh - cutXl) * (yh - cutYh));
+        }
+    }
+    return builder.getLegalInfo();
+}
+
 Rectangle tile2Rectangle(Tile* tile){
     return Rectangle(tile->getLowerLeft().x, tile->getLowerLeft().y, tile->getUpperRight().x, tile->getUpperRight().y);
 }
@@ -5,8 +5,13 @@
 #include <cstdarg>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <atomic>
 #include "LFLegaliser.h"
 #include "DFSLConfig.hpp"
+#include "TileNodeIndex.h"
 
 namespace DFSL {
 
@@ -21,6 +26,7 @@ using namespace boost::polygon::operators;
 #define EPSILON 0.0001
 #define UTIL_RULE 0.8
 #define ASPECT_RATIO_RULE 2.0 
+#define PARALLEL_TASKS_PER_THREAD 8
 
 struct DFSLNode;
 struct DFSLEdge;
@@ -28,13 +34,24 @@ struct Segment;
 struct LegalInfo;
 struct OverlapArea;
 struct MigrationEdge;
+struct TangentRecord;
+struct PathRecord;
+struct SearchFrame;
+struct PathSearchState;
+struct TaskQueue;
+struct EdgeCostEntry;
+struct NodeLegalInfo;
 
-enum class DFSLTessType : unsigned char { OVERLAP, FIXED, SOFT, BLANK };
+// UNUSED: slot of a node dropped by updateGraph(), waiting to be reused
+enum class DFSLTessType : unsigned char { OVERLAP, FIXED, SOFT, BLANK, UNUSED };
 
 enum class DIRECTION : unsigned char { TOP, RIGHT, DOWN, LEFT, NONE };
 
 enum class RESULT : unsigned char { SUCCESS, OVERLAP_NOT_RESOLVED, CONSTRAINT_FAIL };
 
+// state of an mEdgeCostCache slot while the threads of parallelDfs() share it
+enum class EdgeCostClaim : unsigned char { EMPTY, FILLING, READY };
+
 enum DFSL_PRINTLEVEL : int {
     DFSL_ERROR    = 0,
     DFSL_WARNING  = 1,
@@ -45,32 +62,117 @@ enum DFSL_PRINTLEVEL : int {
 class DFSLegalizer{
 private:
     std::vector<DFSLNode> mAllNodes;
+    // nodes of previous graphs, see appendNode()
+    std::vector<DFSLNode> mSpareNodes;
+    // scratch of addBoundaryEdges, one tangent list per direction
+    std::vector<TangentRecord> mTangentRecords[4];
+    // names of the tesserae, indexed like their block nodes (fixed, then soft)
+    std::vector<std::string> mTessNames;
     double mBestCost;
-    int mMigratingArea;
-    int mResolvableArea;
+    area_t mMigratingArea;
+    area_t mResolvableArea;
     std::vector<MigrationEdge> mBestPath;
-    std::vector<MigrationEdge> mCurrentPath;
-    std::multimap<Tile*, int> mTilePtr2NodeIndex;
+    // search state of dfs() (the first one) and of the threads of parallelDfs()
+    std::vector<PathSearchState> mSearchStates;
+    // getEdgeCost() results of the current migrateOverlap() call, one slot per edge (see resetEdgeCostCache()).
+    // A slot is valid if it carries the stamp of the call and the versions of both end nodes
+    std::vector<EdgeCostEntry> mEdgeCostCache;
+    std::vector<int> mEdgeCostOffset;
+    // per slot of mEdgeCostCache during parallelDfs(), the first thread to claim a slot costs its edge
+    std::vector<std::atomic<EdgeCostClaim>> mEdgeCostClaims;
+    unsigned int mEdgeCostStamp;
+    long long mEdgeCostHits;
+    long long mEdgeCostMisses;
+    // LegalInfo of the tiles of each node, valid while the entry carries the version of the node
+    std::vector<NodeLegalInfo> mNodeLegalInfo;
+    TileNodeIndex mTilePtr2NodeIndex;
+    // owner pair key (OverlapOwners::key) -> index of the overlap node
+    std::unordered_map<unsigned long long, int> mOverlapRegistry;
     std::vector<OverlapArea> mTransientOverlapArea;
     LFLegaliser* mLF;
+    // state of the floorplan at the last takeBackup()
+    PlaneSnapshot mBackup;
+    std::vector<OverlapArea> mBackupTransientOverlapArea;
+    bool mHasBackup;
     int mFixedTessNum;
     int mSoftTessNum;
-    int mOverlapNum;
-    int mBlankNum;
+    // constructGraph() lays nodes out as fixed, soft, overlap, blank. updateGraph() keeps every node in its slot,
+    // new nodes take the slots of dropped ones or go to the end, so only block nodes have a fixed range
+    std::vector<int> mOverlapNodes;
+    std::vector<int> mFreeNodes;
+    // nodes changed by migrations since the last graph refresh, see updateGraph()
+    std::vector<int> mDirtyNodes;
+    // scratch of updateGraph(), indexed by node
+    std::vector<char> mNodeDirty;
+    // configs read during legalization, compiled from "config" by compileConfig()
+    DFSLC::CompiledConfig mConfig;
+    // last version handed out to a node, see DFSLNode::version
+    unsigned int mNodeVersion;
+    // per node lower bound of the path cost left to the nearest whitespace, empty until a search needs it.
+    // Clamped to 0 where edge costs can be negative, then it only tells which nodes cannot reach whitespace at all
+    std::vector<double> mWhitespaceBound;
     
     // initialize related functions
     void addOverlapInfo(Tile* tile);
     void addSingleOverlapInfo(Tile* tile, int overlapIdx1, int overlapIdx2);
     void getTessNeighbors(int nodeId, std::set<int>& allNeighbors);
     void addBlockNode(Tessera* tess, bool isFixed);
-    std::string toOverlapName(int tessIndex1, int tessIndex2);
+    // (re)fills the tiles of a node from the floorplan
+    void fillBlockNode(int nodeIndex, Tessera* tess);
+    void fillOverlapNode(int nodeIndex);
+    int addOverlapNode(int overlapIdx1, int overlapIdx2);
+    int addBlankNode(Tile* tile);
+    void addNodeEdges(int fromIndex);
+    void applyTransientOverlapArea();
+    // builds or drops the SoA plane mirror according to UseTilePlane, before the graph reads the plane
+    void syncPlaneMirror();
+    // Refreshes the graph after migrations: only nodes touched by the journaled plane edits (and by mDirtyNodes)
+    // are rebuilt together with their edges, the other nodes and edges are left in place. The result is the graph of
+    // a constructGraph() call up to node numbering, which breaks search ties, so only full rebuilds (the default
+    // IncrementalGraph = 0) reproduce the node order and with it the legalization results
+    void updateGraph();
+    // drops every edge into and out of a node
+    void detachNode(int nodeIndex);
+    // frees the slot of a node that holds no tiles any more
+    void releaseNode(int nodeIndex);
+    // adds an empty node of "type" in a free slot or at the end of mAllNodes, reusing a node of a previous graph when possible
+    DFSLNode& appendNode(DFSLTessType type);
+    void recycleNodes(std::vector<DFSLNode>& nodes);
+    // names are only built for printing: tesserae by interned name, overlaps by owners, blanks by tile address
+    std::string getNodeName(int nodeIndex) const;
 
     // DFS path finding
     bool migrateOverlap(int overlapIndex);
-    void dfs(DFSLEdge& edge, double currentCost);
+    // Exhaustive search of the simple paths from an overlap node to whitespace, pruned by MaxCostCutoff
+    void dfs(int overlapIndex);
+    // Runs the dfs below a path prefix (edge cost slots, starting at the overlap node) on an explicit stack, the best
+    // path is kept by pinning its last record in the path arena. Returns its cost, INT_MAX if there is none.
+    // With sharedBestCost edges are costed through getSharedEdgeCost(), and if no edge cost can be negative subtrees
+    // whose cost plus mWhitespaceBound exceeds it are skipped
+    double searchPaths(PathSearchState& state, int overlapIndex, const std::vector<int>& prefix,
+                       std::vector<MigrationEdge>& bestPath, std::atomic<double>* sharedBestCost);
+    // dfs() on PathSearchThreads threads: the search tree is cut into subtrees that are searched in parallel, the
+    // result is merged in dfs order so the chosen path is the one of dfs(), whatever the thread timing
+    void parallelDfs(int overlapIndex, int threadNum);
+    // getCachedEdgeCost() for the threads of parallelDfs(): the thread claiming the slot costs the edge, a thread
+    // finding it claimed but not ready costs it into its own scratch instead of waiting
+    const MigrationEdge& getSharedEdgeCost(DFSLEdge& edge, int slot, PathSearchState& state);
+    // Best-first (A*) alternative to dfs(): nodes are settled in order of cost + mWhitespaceBound, every node at most
+    // once, and the search stops at the first whitespace settled. Exact since ConfigList::compile() rejects weights
+    // that allow negative edge costs
+    void bestFirstSearch(int overlapIndex);
+    void computeWhitespaceBound();
     MigrationEdge getEdgeCost(DFSLEdge& edge);
-    void DFSLTraverseBlank(Tile* tile, std::vector <Cord> &record);
+    // getEdgeCost() through mEdgeCostCache, mMigratingArea must not change until the next resetEdgeCostCache()
+    const MigrationEdge& getCachedEdgeCost(DFSLEdge& edge);
+    void resetEdgeCostCache();
+    const LegalInfo& getNodeLegalInfo(int nodeIndex);
+    void DFSLTraverseBlank(Tile* tile);
     void findEdge(int fromIndex, int toIndex);
+    // One walk over the boundary of node "fromIndex" emits its edges to every destination at once, tangent segments
+    // are bucketed by the node across the boundary. With "onlyTo" != -1 only the edge to that node is built
+    void addBoundaryEdges(int fromIndex, int onlyTo);
+    static void spliceTangentSegments(std::vector<Segment>& currentSegment, int dir, std::vector<Segment>& allTangentSegments);
     Rectangle getRectFromEdge(MigrationEdge& edge, bool findRemainder, Rectangle& remainderRect, bool useCeil);
 
     // functions that change physical layout
@@ -83,11 +185,22 @@ public:
     DFSLegalizer();
     ~DFSLegalizer();
     void setOutputLevel(DFSL_PRINTLEVEL level);
+    // validates "config" and takes a snapshot of it, invalid configs throw std::invalid_argument.
+    // legalize() compiles again, so changes made to "config" before it are picked up
+    void compileConfig();
     void initDFSLegalizer(LFLegaliser* floorplan);
     void constructGraph();
     RESULT legalize(int mode);
+    // deep copy of the floorplan for restoreBackup(), legalize() does not take one by itself
+    void takeBackup();
+    // rolls the floorplan back to the last takeBackup() and rebuilds the graph,
+    // returns false if there is no backup
+    bool restoreBackup();
     void DFSLPrint(int level, const char* fmt...);
     void printFloorplanStats();
+    // edge cost cache counters, summed over all searches
+    long long getEdgeCostCacheHits() const;
+    long long getEdgeCostCacheMisses() const;
     DFSLC::ConfigList config;
 };
 
@@ -100,6 +213,12 @@ static bool compareYSegment(Segment a, Segment b);
 LegalInfo getLegalInfo(std::vector<Tile*>& tiles); 
 LegalInfo getLegalInfo(std::set<Tile*>& tiles); 
 LegalInfo getLegalInfo(Polygon90Set& tiles); 
+// Closed-form cost kernel: the LegalInfo of a block of disjoint tiles after adding or removing a rectangle,
+// computed on the tiles without polygon booleans
+area_t getIntersectArea(std::vector<Tile*>& tiles, const Rectangle& rect);
+// "info" is the LegalInfo of the tiles
+LegalInfo getLegalInfoWithRect(const LegalInfo& info, std::vector<Tile*>& tiles, const Rectangle& rect);
+LegalInfo getLegalInfoWithoutRect(std::vector<Tile*>& tiles, const Rectangle& rect);
 
 Rectangle tile2Rectangle(Tile* tile);
 
@@ -108,15 +227,39 @@ void TileVec2PolySet(std::vector<Tile*>& tileVec, Polygon90Set& polySet);
 // find the segment in poly of the same orientation that has the shortest distance
 Segment FindNearestOverlappingInterval(Segment& seg, Polygon90Set& poly);
 
+// Sorted set of the tesserae (node indices) sharing an overlap node, stored inline.
+// Overlap nodes are created per pair of tesserae, so the capacity is two
+struct OverlapOwners {
+    static const int CAPACITY = 2;
+    OverlapOwners();
+    void insert(int index);
+    int count(int index) const;
+    int size() const;
+    const int* begin() const;
+    const int* end() const;
+    int front() const;
+    int back() const;
+    // key of the owner pair in DFSLegalizer::mOverlapRegistry
+    unsigned long long key() const;
+    static unsigned long long key(int index1, int index2);
+private:
+    int mIndices[CAPACITY];
+    int mSize;
+};
+
 struct DFSLNode {
     DFSLNode();
     std::vector<Tile*> tileList; 
+    // sorted by toIndex
     std::vector<DFSLEdge> edgeList;
-    std::set<int> overlaps;
-    std::string nodeName;
+    // nodes with an edge into this one
+    std::vector<int> predecessors;
+    OverlapOwners overlaps;
     DFSLTessType nodeType;
-    int area;
+    area_t area;
     int index;
+    // changes whenever the node is rebuilt, nodes carried over unchanged by updateGraph() keep theirs
+    unsigned int version;
 };
 
 // note: use ONLY on vertical and horizontal segments 
@@ -126,6 +269,12 @@ struct Segment {
     DIRECTION direction; // direction of the normal vector of this segment
 };
 
+// a tangent segment found on the boundary of a node, and the node on the other side
+struct TangentRecord {
+    int toIndex;
+    Segment segment;
+};
+
 struct DFSLEdge {
     int fromIndex;
     int toIndex; 
@@ -142,23 +291,78 @@ struct MigrationEdge {
     MigrationEdge(int from, int to, Rectangle& area, Segment& seg, double cost);
 };
 
+// one edge of a dfs path, linked to the record of the previous edge
+struct PathRecord {
+    MigrationEdge edge;
+    int parent;
+    int refs;
+};
+
+struct EdgeCostEntry {
+    MigrationEdge result;
+    unsigned int stamp;
+    unsigned int fromVersion;
+    unsigned int toVersion;
+};
+
+struct SearchFrame {
+    int nodeIndex;
+    int record;
+    int nextEdge;
+    double cost;
+};
+
+struct PathSearchState {
+    std::vector<PathRecord> pathArena;
+    std::vector<int> freeRecords;
+    std::vector<SearchFrame> searchStack;
+    // nodes of the current path
+    std::vector<bool> onPath;
+    // edge cost of getSharedEdgeCost() when the slot is being filled by another thread
+    MigrationEdge scratch;
+    long long hits;
+    long long misses;
+};
+
+struct TaskQueue {
+    std::mutex mutex;
+    std::deque<int> tasks;
+};
+
 struct LegalInfo {
     // bounding box related
     Cord BL;
-    int width;
-    int height;
-    int bbArea;
+    len_t width;
+    len_t height;
+    area_t bbArea;
     double aspectRatio; // w/h
 
     // utilization
-    int actualArea;
+    area_t actualArea;
     double util;
 };
 
+// accumulates bounding box and area of disjoint rectangles
+struct LegalInfoBuilder {
+    LegalInfoBuilder();
+    void add(len_t xl, len_t yl, len_t xh, len_t yh, area_t area);
+    void add(Tile* tile);
+    LegalInfo getLegalInfo() const;
+private:
+    len_t minX, minY, maxX, maxY;
+    area_t actualArea;
+};
+
+struct NodeLegalInfo {
+    unsigned int version;
+    LegalInfo info;
+    NodeLegalInfo(): version(0) {}
+};
+
 struct OverlapArea {
     int index1;
     int index2;
-    int area;
+    area_t area;
 };
 
 }
@@ -2,22 +2,23 @@
 #include <fstream>
 #include <sstream>
 #include <stdio.h>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <random>
 #include "LFLegaliser.h"
+#include "OverlapSweep.h"
 
 LFLegaliser::LFLegaliser(len_t chipWidth, len_t chipHeight)
-    : mCanvasWidth(chipWidth), mCanvasHeight(chipHeight) {}
+    : mCanvasWidth(chipWidth), mCanvasHeight(chipHeight), overlap3(false), mPlaneVersion(0), mVisitEpoch(0), mAreaQueryActive(false), mEditJournalOn(false) {
+        resetPointHints();
+    }
 
 LFLegaliser::~LFLegaliser() {
 
-    // Collect all the tiles for cleanUp
-    std::vector<Tile *> tileBin;
-
-    collectAllTiles(tileBin);
-
-    for(int i = 0; i < tileBin.size(); ++i){
-        // std::cout << "Delete " << *(tileBin[i]) << std::endl;
-        delete(tileBin[i]);
-    }
+    // Every tile lives in mTilePool, recycle them all at once
+    mTilePool.releaseAll();
 
     // All Tiles are recycled, now delete all tessera
     for (int i = 0; i < softTesserae.size(); ++i){
@@ -29,135 +30,81 @@ LFLegaliser::~LFLegaliser() {
 
 }
 
-// TODO for ryan: copy constructor fails for cases where zero area tiles exist
+// Tiles are cloned slot by slot, so every tile keeps its pool handle and all pointers are remapped by handle in O(n)
 LFLegaliser::LFLegaliser(const LFLegaliser &other){
     this->mCanvasWidth = other.mCanvasWidth;
     this->mCanvasHeight = other.mCanvasHeight;
     this->overlap3 = other.overlap3;
+    this->mVisitEpoch = 0;
+    this->mAreaQueryActive = false;
+    this->mPlaneVersion = 0;
+    this->mEditJournalOn = false;
+    resetPointHints();
     this->connectionList = other.connectionList;
 
-    std::vector <Tile *> allOldTiles;
-    other.collectAllTiles(allOldTiles);
+    mTilePool.cloneFrom(other.mTilePool);
 
-    std::vector <CPTilePair *> pairs;
-    for(Tile *t : allOldTiles){
-        CPTilePair *cp = new CPTilePair();
-        cp->father = t;
-        cp->baby = new Tile((*t));
-        pairs.push_back(cp);
+    for(Tessera *oldT : other.fixedTesserae){
+        Tessera* newTess = new Tessera((*oldT));
+        newTess->setTilePool(&(this->mTilePool));
+        remapTesseraTiles(newTess);
+        this->fixedTesserae.push_back(newTess);
     }
 
-    // maintain the pointers for the new tiles
-    for(CPTilePair *fixLinkHead : pairs){
-        
-        if(fixLinkHead->father->rt != nullptr){
-            Tile *newLink = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == fixLinkHead->father->rt->getLowerLeft()){
-                    newLink = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newLink != nullptr);
-            fixLinkHead->baby->rt = newLink;
-        }
-        if(fixLinkHead->father->lb != nullptr){
-            Tile *newLink = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == fixLinkHead->father->lb->getLowerLeft()){
-                    newLink = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newLink != nullptr);
-            fixLinkHead->baby->lb = newLink;
-        }
-        if(fixLinkHead->father->bl != nullptr){
-            Tile *newLink = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == fixLinkHead->father->bl->getLowerLeft()){
-                    newLink = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newLink != nullptr);
-            fixLinkHead->baby->bl = newLink;
-        }
-        if(fixLinkHead->father->tr != nullptr){
-            Tile *newLink = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == fixLinkHead->father->tr->getLowerLeft()){
-                    newLink = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newLink != nullptr);
-            fixLinkHead->baby->tr = newLink;
-        }
+    for(Tessera *oldT : other.softTesserae){
+        Tessera* newTess = new Tessera((*oldT));
+        newTess->setTilePool(&(this->mTilePool));
+        remapTesseraTiles(newTess);
+        this->softTesserae.push_back(newTess);
+    }
 
+    for(Tile *t : other.mMarkedTiles){
+        this->mMarkedTiles.push_back(mTilePool.translate(t));
     }
+}
 
-    for(Tessera *oldT : other.fixedTesserae){
-        Tessera* newTess = new Tessera((*oldT));
-        newTess->TileArr.clear();
-        for(Tile *t : oldT->TileArr){
-            Tile *newTileReplacement = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == t->getLowerLeft()){
-                    newTileReplacement = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newTileReplacement != nullptr);
-            newTess->TileArr.push_back(newTileReplacement);
-        }
+void LFLegaliser::remapTesseraTiles(Tessera *tess){
+    for(int i = 0; i < tess->TileArr.size(); ++i){
+        tess->TileArr[i] = mTilePool.translate(tess->TileArr[i]);
+    }
+    for(int i = 0; i < tess->OverlapArr.size(); ++i){
+        tess->OverlapArr[i] = mTilePool.translate(tess->OverlapArr[i]);
+    }
+}
 
-        newTess->OverlapArr.clear();
-        for(Tile *t : oldT->OverlapArr){
-            Tile *newTileReplacement = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == t->getLowerLeft()){
-                    newTileReplacement = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newTileReplacement != nullptr);
-            newTess->OverlapArr.push_back(newTileReplacement);
-        }
+void LFLegaliser::takeSnapshot(PlaneSnapshot &snap) const{
+    mTilePool.takeSnapshot(snap.pool);
 
-        this->fixedTesserae.push_back(newTess);
+    snap.fixedTesserae.clear();
+    for(Tessera *tess : this->fixedTesserae){
+        snap.fixedTesserae.push_back(*tess);
     }
+    snap.softTesserae.clear();
+    for(Tessera *tess : this->softTesserae){
+        snap.softTesserae.push_back(*tess);
+    }
+    snap.markedTiles = this->mMarkedTiles;
+    snap.overlap3 = this->overlap3;
+}
 
-    for(Tessera *oldT : other.softTesserae){
-        Tessera* newTess = new Tessera((*oldT));
-        newTess->TileArr.clear();
-        for(Tile *t : oldT->TileArr){
-            Tile *newTileReplacement = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == t->getLowerLeft()){
-                    newTileReplacement = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newTileReplacement != nullptr);
-            newTess->TileArr.push_back(newTileReplacement);
-        }
+void LFLegaliser::restoreSnapshot(const PlaneSnapshot &snap){
+    assert(snap.fixedTesserae.size() == this->fixedTesserae.size());
+    assert(snap.softTesserae.size() == this->softTesserae.size());
 
-        newTess->OverlapArr.clear();
-        for(Tile *t : oldT->OverlapArr){
-            Tile *newTileReplacement = nullptr;
-            for(CPTilePair *findingHead : pairs){
-                if(findingHead->father->getLowerLeft() == t->getLowerLeft()){
-                    newTileReplacement = findingHead->baby;
-                    break;
-                }
-            }
-            assert(newTileReplacement != nullptr);
-            newTess->OverlapArr.push_back(newTileReplacement);
-        }
+    touchPlane();
+    mTilePool.restoreSnapshot(snap.pool);
 
-        this->softTesserae.push_back(newTess);
-    } 
+    for(int i = 0; i < this->fixedTesserae.size(); ++i){
+        (*this->fixedTesserae[i]) = snap.fixedTesserae[i];
+    }
+    for(int i = 0; i < this->softTesserae.size(); ++i){
+        (*this->softTesserae[i]) = snap.softTesserae[i];
+    }
+    this->mMarkedTiles = snap.markedTiles;
+    this->overlap3 = snap.overlap3;
+
+    // slots were rewritten in place, old hints may point into a different part of the plane now
+    resetPointHints();
 }
 
 bool LFLegaliser::checkTesseraInCanvas(Cord lowerLeft, len_t width, len_t height) const {
@@ -176,21 +123,131 @@ bool LFLegaliser::checkTileInCanvas(Tile &tile) const{
 
 Tile *LFLegaliser::getRandomTile() const{
     assert(!(fixedTesserae.empty() && softTesserae.empty()));
+    auto anyTile = [](const Tessera *tess) -> Tile *{
+        if(!tess->TileArr.empty()) return tess->TileArr[0];
+        if(!tess->OverlapArr.empty()) return tess->OverlapArr[0];
+        return nullptr;
+    };
     
     // modified by ryan
     // original: if(!fixedTesserae.empty()){
+    Tile *seed = nullptr;
     if(!fixedTesserae.empty() && fixedTesserae[0]->getLegalArea() != 0){
-        if(!fixedTesserae[0]->TileArr.empty()){
-            return fixedTesserae[0]->TileArr[0];        
-        }else{
-            return fixedTesserae[0]->OverlapArr[0];        
-        }
-    }else{
-        if(!softTesserae[0]->TileArr.empty()){
-            return softTesserae[0]->TileArr[0];
-        }else{
-            return softTesserae[0]->OverlapArr[0];
-        }
+        seed = anyTile(fixedTesserae[0]);
+    }else if(!softTesserae.empty()){
+        seed = anyTile(softTesserae[0]);
+    }
+    if(seed != nullptr) return seed;
+
+    // deleteTile emptied that Tessera, every tile still held by a Tessera is in the plane
+    for(const Tessera *tess : fixedTesserae){
+        if((seed = anyTile(tess)) != nullptr) return seed;
+    }
+    for(const Tessera *tess : softTesserae){
+        if((seed = anyTile(tess)) != nullptr) return seed;
+    }
+
+    // no solid tile left, the plane is the single blank spanning the canvas
+    for(unsigned int handle = 0; handle < mTilePool.getCapacity(); ++handle){
+        if(!mTilePool.isInUse(handle)) continue;
+        Tile *t = mTilePool.getTile(handle);
+        if(t->getType() == tileType::BLANK && t->getWidth() == mCanvasWidth && t->getHeight() == mCanvasHeight) return t;
+    }
+    return nullptr;
+}
+
+Tile *LFLegaliser::allocateTile(tileType t, Cord LL, len_t w, len_t h){
+    touchPlane();
+    return mTilePool.allocate(t, LL, w, h);
+}
+
+Tile *LFLegaliser::allocateTile(const Tile &other){
+    touchPlane();
+    return mTilePool.allocate(other);
+}
+
+void LFLegaliser::releaseTile(Tile *tile){
+    touchPlane();
+    mTilePool.release(tile);
+}
+
+TilePool &LFLegaliser::getTilePool(){
+    // the caller may edit tiles behind our back
+    touchPlane();
+    return mTilePool;
+}
+
+void LFLegaliser::touchPlane(){
+    mPlaneVersion++;
+}
+
+bool LFLegaliser::tilePlaneActive() const{
+    return mTilePlane.isCurrent(mPlaneVersion);
+}
+
+void LFLegaliser::syncTilePlane(){
+    if(!mTilePlane.isCurrent(mPlaneVersion)){
+        mTilePlane.build(mTilePool, mPlaneVersion);
+    }
+}
+
+void LFLegaliser::dropTilePlane(){
+    mTilePlane.clear();
+}
+
+const TilePlane &LFLegaliser::getTilePlane() const{
+    return mTilePlane;
+}
+
+void LFLegaliser::setEditJournal(bool enable){
+    mEditJournalOn = enable;
+    clearEditJournal();
+}
+
+bool LFLegaliser::isEditJournalOn() const{
+    return mEditJournalOn;
+}
+
+void LFLegaliser::clearEditJournal(){
+    mEditedAreas.clear();
+    mEditedTiles.clear();
+}
+
+const std::vector<Rectangle> &LFLegaliser::getEditedAreas() const{
+    return mEditedAreas;
+}
+
+const std::vector<Tile *> &LFLegaliser::getEditedTiles() const{
+    return mEditedTiles;
+}
+
+void LFLegaliser::journalEdit(Cord lowerLeft, len_t width, len_t height){
+    if(!mEditJournalOn) return;
+
+    // grown by one unit so tiles only sharing an edge or a corner with the area are caught as well
+    len_t xl = std::max<len_t>(lowerLeft.x - 1, 0);
+    len_t yl = std::max<len_t>(lowerLeft.y - 1, 0);
+    len_t xh = std::min<len_t>(lowerLeft.x + width + 1, mCanvasWidth);
+    len_t yh = std::min<len_t>(lowerLeft.y + height + 1, mCanvasHeight);
+    mEditedAreas.push_back(Rectangle(xl, yl, xh, yh));
+    enumerateDirectArea(Cord(xl, yl), xh - xl, yh - yl, [this](Tile *t){
+        mEditedTiles.push_back(t);
+        return true;
+    });
+}
+
+void LFLegaliser::collectEditedNeighbourhood(std::vector<Tile *> &tiles) const{
+    tiles.clear();
+    const unsigned long long epoch = nextVisitEpoch();
+    for(const Rectangle &area : mEditedAreas){
+        enumerateDirectArea(Cord(gtl::xl(area), gtl::yl(area)), gtl::delta(area, gtl::HORIZONTAL), gtl::delta(area, gtl::VERTICAL),
+            [&tiles, epoch](Tile *t){
+                if(t->visitStamp != epoch){
+                    t->visitStamp = epoch;
+                    tiles.push_back(t);
+                }
+                return true;
+            });
     }
 }
 
@@ -240,15 +297,17 @@ bool LFLegaliser::initFromGlobalFile(std::string path){
         return false;
     }
     std::string type, name, s;
-    int blockNum, area, w, h;
+    int blockNum;
+    area_t area;
+    len_t w, h;
     double llx, lly;
     int connectionNum;
     fin >> s >> blockNum >> s >> connectionNum;
     fin >> this->mCanvasWidth >> this->mCanvasHeight;
     for (int i = 0; i < blockNum; i++){
         fin >> name >> type >> area >> llx >> lly >> w >> h;
-        int intx = round(llx);
-        int inty = round(lly);
+        len_t intx = round(llx);
+        len_t inty = round(lly);
         if (intx < 0 || inty < 0 || (intx + w) > this->mCanvasWidth || (inty + h) > this->mCanvasHeight){
             std::cout << "[LFL] Warning: in initfromGlobalFile, module " << name << " exceeds canvas\n";
             if (intx < 0){
@@ -267,12 +326,14 @@ bool LFLegaliser::initFromGlobalFile(std::string path){
 
         if ( type == "FIXED" ) {
             Tessera *newTess = new Tessera(tesseraType::HARD, name, area,
-                Cord(intx, inty), w, h);
+                Cord(intx, inty), w, h, &(this->mTilePool));
+            newTess->setIndex(fixedTesserae.size());
             fixedTesserae.push_back(newTess);
         }
         else {
             Tessera *newTess = new Tessera(tesseraType::SOFT, name, area,
-                Cord(intx, inty), w, h);
+                Cord(intx, inty), w, h, &(this->mTilePool));
+            newTess->setIndex(softTesserae.size());
             softTesserae.push_back(newTess);
         }
     }
@@ -304,7 +365,9 @@ void LFLegaliser::initFromFile(std::string path){
 
     std::ifstream fin(path, std::ifstream::in);
     std::string type, name, s;
-    int blockNum, area, llx, lly, w, h;
+    int blockNum;
+    area_t area;
+    len_t llx, lly, w, h;
     int softNum, overlapNum;
     fin >> s >> blockNum;
     fin >> this->mCanvasWidth >> this->mCanvasHeight;
@@ -312,11 +375,13 @@ void LFLegaliser::initFromFile(std::string path){
         fin >> name >> area >> llx >> lly >> w >> h >> type;
         Tessera* newTess;
         if (type == "HARD_BLOCK"){
-            newTess = new Tessera(tesseraType::HARD, name, area, Cord(llx, lly), w, h);
+            newTess = new Tessera(tesseraType::HARD, name, area, Cord(llx, lly), w, h, &(this->mTilePool));
+            newTess->setIndex(fixedTesserae.size());
             fixedTesserae.push_back(newTess);
         }
         else {
-            newTess = new Tessera(tesseraType::SOFT, name, area, Cord(llx, lly), w, h);
+            newTess = new Tessera(tesseraType::SOFT, name, area, Cord(llx, lly), w, h, &(this->mTilePool));
+            newTess->setIndex(softTesserae.size());
             softTesserae.push_back(newTess);   
         }
         fin >> softNum >> overlapNum;
@@ -362,6 +427,7 @@ void LFLegaliser::initFromFile(std::string path){
 // }
 
 void LFLegaliser::detectfloorplanningOverlaps() {
+    touchPlane();
     // If an overlap is detected, You should:
     // 1. Locate the overlap and crate a new Tile marking the overlap, the tile should include the spacing info and the voerlap Tessera idx
     // Tile *overlapTile = new Tile(tileType::OVERLAP, Cord(1,3), 4, 5);
@@ -371,133 +437,28 @@ void LFLegaliser::detectfloorplanningOverlaps() {
     // 2. Split (both) the Tesserae into smaller tiles if it become rectlinear.
     // 3. Update (both) the Tesserae's tile list.
 
-    //first we create an object to do the connectivity extraction
-    using namespace boost::polygon::operators;
-
-    gtl::connectivity_extraction_90<int> ce;
-
-    std::vector<Rectangle> test_data;
+    // ids: soft tesserae first, then fixed ones
+    OverlapSweep sweep;
     for ( Tessera *curTes : softTesserae ) {
-        Cord lowerLeft = curTes->TileArr[0]->getLowerLeft();
-        Cord upperRight = curTes->TileArr[0]->getUpperRight();
-        test_data.push_back(Rectangle(lowerLeft.x, lowerLeft.y, upperRight.x, upperRight.y));
+        Tile *tile = curTes->TileArr[0];
+        sweep.insert(tile->getLowerLeft(), tile->getWidth(), tile->getHeight());
     }
-
     for ( Tessera *curTes : fixedTesserae ) {
-        Cord lowerLeft = curTes->TileArr[0]->getLowerLeft();
-        Cord upperRight = curTes->TileArr[0]->getUpperRight();
-        test_data.push_back(Rectangle(lowerLeft.x, lowerLeft.y, upperRight.x, upperRight.y));
-    }
-
-    for ( unsigned int i = 0; i < test_data.size(); ++i ) {
-        //insert returns an id starting at zero and incrementing
-        //with each call
-        assert(ce.insert(test_data[i]) == i);
+        Tile *tile = curTes->TileArr[0];
+        sweep.insert(tile->getLowerLeft(), tile->getWidth(), tile->getHeight());
     }
-    //notice that ids returned by ce.insert happen to match
-    //index into vector of inputs in this case
-
-    //make sure the vector graph has elements for our nodes
-    std::vector< std::set<len_t> > graph(test_data.size());
 
-    //populate the graph with edge data
-    ce.extract(graph);
-
-    struct IntersectionUnit
-    {
-        Rectangle intersection;
-        std::vector<int> overlappedIDs;
-    };
+    // every region comes with the full set of tesserae covering it, deepest overlaps first
+    std::vector<OverlapRect> regions;
+    sweep.extract(regions, 2);
 
-    
-    // 2 overlapped
-    std::vector<IntersectionUnit> overlap2unit;
-    for ( int i = 0; i < test_data.size(); i++ ) {
-        for ( int n : graph[i] ) {
-            if ( n < i ) {
-                continue;
-            }
-            PolygonSet intersections;
-            intersections += test_data[i] & test_data[n];
-            if ( intersections.empty() ) {
-                continue;
-            }
-            Rectangle intersectBox;
-            gtl::extents(intersectBox, intersections);
-            IntersectionUnit iu;
-            iu.intersection = intersectBox;
-            iu.overlappedIDs.push_back(i);
-            iu.overlappedIDs.push_back(n);
-            overlap2unit.push_back(iu);
-        }
-    }
-
-    // 3 overlapped
-    std::vector<IntersectionUnit> overlap3unit;
-    for ( IntersectionUnit &o2unit: overlap2unit ) {
-        int olID0 = o2unit.overlappedIDs[0], olID1 = o2unit.overlappedIDs[1];
-        for ( int n : graph[olID1] ) {
-            if ( n <= olID1 ) {
-                continue;
-            }
-            PolygonSet intersections;
-            intersections += o2unit.intersection & test_data[n];
-            if ( intersections.empty() ) {
-                continue;
-            }
-            printf("%2d %2d %2d\n", olID0, olID1, n);
-            std::cout << "3 Modules Intersection: " << intersections << std::endl;
-            Rectangle intersectBox;
-            gtl::extents(intersectBox, intersections);
-            IntersectionUnit iu;
-            iu.intersection = intersectBox;
-            iu.overlappedIDs.push_back(olID0);
-            iu.overlappedIDs.push_back(olID1);
-            iu.overlappedIDs.push_back(n);
-            overlap3unit.push_back(iu);
-        }
-    }
-
-    // 4 overlapped
-    std::vector<IntersectionUnit> overlap4unit;
-    for ( IntersectionUnit &o3unit: overlap3unit ) {
-        int olID0 = o3unit.overlappedIDs[0], olID1 = o3unit.overlappedIDs[1], olID2 = o3unit.overlappedIDs[2];
-        for ( int n : graph[olID2] ) {
-            if ( n <= olID2 ) {
-                continue;
-            }
-            PolygonSet intersections;
-            intersections += o3unit.intersection & test_data[n];
-            if ( intersections.empty() ) {
-                continue;
-            }
-            printf("%2d %2d %2d %2d\n", olID0, olID1, olID2, n);
-            std::cout << "4 Modules Intersection: " << intersections << std::endl;
-            Rectangle intersectBox;
-            gtl::extents(intersectBox, intersections);
-            IntersectionUnit iu;
-            iu.intersection = intersectBox;
-            iu.overlappedIDs.push_back(olID0);
-            iu.overlappedIDs.push_back(olID1);
-            iu.overlappedIDs.push_back(olID2);
-            iu.overlappedIDs.push_back(n);
-            overlap4unit.push_back(iu);
-        }
-    }
-
-    // add these tiles
-    std::vector<Tile> overlap4TileVec;
-    for ( IntersectionUnit &o4unit: overlap4unit ) {
-        Rectangle intersectBox = o4unit.intersection;
-        len_t x = gtl::xl(intersectBox);
-        len_t y = gtl::yl(intersectBox);
-        len_t w = gtl::xh(intersectBox) - gtl::xl(intersectBox);
-        len_t h = gtl::yh(intersectBox) - gtl::yl(intersectBox);
-        Tile overlapTileRef(tileType::OVERLAP, Cord(x, y), w, h);
-        overlap4TileVec.push_back(overlapTileRef);
-
-        Tile *overlapTile = new Tile(tileType::OVERLAP, Cord(x, y), w, h);
-        for ( int i : o4unit.overlappedIDs ) {
+    this->overlap3 = false;
+    for ( OverlapRect &region : regions ) {
+        if ( region.owners.size() >= 3 ) {
+            this->overlap3 = true;
+        }
+        Tile *overlapTile = mTilePool.allocate(tileType::OVERLAP, region.lowerLeft, region.width, region.height);
+        for ( int i : region.owners ) {
             bool isSoft = i < softTesserae.size();
             int id = ( isSoft ) ? i : i - softTesserae.size();
             Tessera *curTess = ( isSoft ) ? softTesserae[id] : fixedTesserae[id];
@@ -508,59 +469,6 @@ void LFLegaliser::detectfloorplanningOverlaps() {
         }
     }
 
-    std::vector<Tile> overlap3TileVec;
-    for ( IntersectionUnit &o3unit: overlap3unit ) {
-        Rectangle intersectBox = o3unit.intersection;
-        len_t x = gtl::xl(intersectBox);
-        len_t y = gtl::yl(intersectBox);
-        len_t w = gtl::xh(intersectBox) - gtl::xl(intersectBox);
-        len_t h = gtl::yh(intersectBox) - gtl::yl(intersectBox);
-        Tile overlapTileRef(tileType::OVERLAP, Cord(x, y), w, h);
-        overlap3TileVec.push_back(overlapTileRef);
-
-        std::vector<Tile> interection3TileVec;
-        interection3TileVec.push_back(Tile(tileType::OVERLAP, Cord(x, y), w, h));
-        std::vector<Tile> cuttedTiles = mergeCutTiles(interection3TileVec, overlap4TileVec);
-
-        for ( auto &tile : cuttedTiles ) {
-            Tile *overlapTile = new Tile(tileType::OVERLAP, tile.getLowerLeft(), tile.getWidth(), tile.getHeight());
-            for ( int i : o3unit.overlappedIDs ) {
-                bool isSoft = i < softTesserae.size();
-                int id = ( isSoft ) ? i : i - softTesserae.size();
-                Tessera *curTess = ( isSoft ) ? softTesserae[id] : fixedTesserae[id];
-
-                ( isSoft ) ? overlapTile->OverlapSoftTesseraeIdx.push_back(id)
-                    : overlapTile->OverlapFixedTesseraeIdx.push_back(id);
-                curTess->insertTiles(overlapTile);
-            }
-        }
-    }
-
-    for ( IntersectionUnit &o2unit: overlap2unit ) {
-        Rectangle intersectBox = o2unit.intersection;
-        len_t x = gtl::xl(intersectBox);
-        len_t y = gtl::yl(intersectBox);
-        len_t w = gtl::xh(intersectBox) - gtl::xl(intersectBox);
-        len_t h = gtl::yh(intersectBox) - gtl::yl(intersectBox);
-
-        std::vector<Tile> interection2TileVec;
-        interection2TileVec.push_back(Tile(tileType::OVERLAP, Cord(x, y), w, h));
-        std::vector<Tile> cuttedTiles = mergeCutTiles(interection2TileVec, overlap3TileVec);
-
-        for ( auto &tile : cuttedTiles ) {
-            Tile *overlapTile = new Tile(tileType::OVERLAP, tile.getLowerLeft(), tile.getWidth(), tile.getHeight());
-            for ( int i : o2unit.overlappedIDs ) {
-                bool isSoft = i < softTesserae.size();
-                int id = ( isSoft ) ? i : i - softTesserae.size();
-                Tessera *curTess = ( isSoft ) ? softTesserae[id] : fixedTesserae[id];
-
-                ( isSoft ) ? overlapTile->OverlapSoftTesseraeIdx.push_back(id)
-                    : overlapTile->OverlapFixedTesseraeIdx.push_back(id);
-                curTess->insertTiles(overlapTile);
-            }
-        }
-    }
-
 }
 
 bool LFLegaliser::has3overlap() {
@@ -568,24 +476,96 @@ bool LFLegaliser::has3overlap() {
 }
 
 void LFLegaliser::splitTesseraeOverlaps(){
+    touchPlane();
     // Soft&Hard block overlap are located and split if necessary in OverlapArr of each Tessera
     // now cut rectlinear blank space of each Tessera into multiple blank tiles.
 
+    std::vector <Tessera *> splitTess;
     for(Tessera *fixedTess : this->fixedTesserae){
         // added by ryan
         if (fixedTess->getLegalArea() == 0){
             continue;
         }
-        fixedTess->splitRectliearDueToOverlap();
+        splitTess.push_back(fixedTess);
     }
-
     for(Tessera *softTess : this->softTesserae){
         // added by ryan
         if (softTess->getLegalArea() == 0){
             continue;
         }
-        softTess->splitRectliearDueToOverlap();
+        splitTess.push_back(softTess);
+    }
+
+    // every Tessera is split independently, only handing the strips over to the tile pool has to be serial
+    std::vector <std::vector<StripRect>> strips(splitTess.size());
+    std::vector <char> needSplit(splitTess.size(), 0);
+    unsigned int threadNum = 1;
+    if(splitTess.size() >= SPLIT_THREAD_THRESHOLD){
+        threadNum = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if(threadNum == 1){
+        for(int i = 0; i < splitTess.size(); ++i){
+            needSplit[i] = splitTess[i]->computeSplitStrips(strips[i]);
+        }
+    }else{
+        std::atomic<int> next(0);
+        std::vector <std::thread> workers;
+        for(unsigned int t = 0; t < threadNum; ++t){
+            workers.push_back(std::thread([&](){
+                for(int i = next++; i < (int) splitTess.size(); i = next++){
+                    needSplit[i] = splitTess[i]->computeSplitStrips(strips[i]);
+                }
+            }));
+        }
+        for(std::thread &worker : workers){
+            worker.join();
+        }
+    }
+
+    for(int i = 0; i < splitTess.size(); ++i){
+        if(needSplit[i]) splitTess[i]->applySplitStrips(strips[i]);
+    }
+}
+
+void LFLegaliser::resetPointHints(){
+    mPointHints.clear();
+    mHintCellWidth = 0;
+    mHintCellHeight = 0;
+    mLastHitTile = nullptr;
+    mLastHitGeneration = 0;
+}
+
+Tile *LFLegaliser::getPointHint(const Cord &key) const{
+    const TilePool &pool = this->mTilePool;
+    auto isValid = [&pool](Tile *t, unsigned int generation){
+        return (t != nullptr) && pool.isInUse(t->getHandle()) && (pool.getGeneration(t->getHandle()) == generation);
+    };
+
+    if(!mPointHints.empty()){
+        const PointHint &hint = mPointHints[(key.y / mHintCellHeight) * POINT_HINT_GRID_DIM + (key.x / mHintCellWidth)];
+        if(isValid(hint.tile, hint.generation)) return hint.tile;
+    }
+    if(isValid(mLastHitTile, mLastHitGeneration)) return mLastHitTile;
+
+    return getRandomTile();
+}
+
+void LFLegaliser::setPointHint(const Cord &key, Tile *tile) const{
+    if(tile->getHandle() == Tile::NULL_HANDLE) return;
+    unsigned int generation = mTilePool.getGeneration(tile->getHandle());
+
+    // the canvas size is only known after input parsing, build the grid lazily
+    if(mPointHints.empty()){
+        mHintCellWidth = (mCanvasWidth + POINT_HINT_GRID_DIM - 1) / POINT_HINT_GRID_DIM;
+        mHintCellHeight = (mCanvasHeight + POINT_HINT_GRID_DIM - 1) / POINT_HINT_GRID_DIM;
+        if(mHintCellWidth < 1) mHintCellWidth = 1;
+        if(mHintCellHeight < 1) mHintCellHeight = 1;
+        mPointHints.assign(POINT_HINT_GRID_DIM * POINT_HINT_GRID_DIM, {nullptr, 0});
     }
+    
+    mPointHints[(key.y / mHintCellHeight) * POINT_HINT_GRID_DIM + (key.x / mHintCellWidth)] = {tile, generation};
+    mLastHitTile = tile;
+    mLastHitGeneration = generation;
 }
 
 Tile *LFLegaliser::findPoint(const Cord &key) const{
@@ -593,7 +573,13 @@ Tile *LFLegaliser::findPoint(const Cord &key) const{
     assert(key.x < getCanvasWidth());
     assert(key.y < getCanvasHeight());
 
-    Tile *index = getRandomTile();
+    Tile *index = getPointHint(key);
+
+    if(tilePlaneActive()){
+        index = mTilePlane.getTile(mTilePlane.findPoint(key, index->getHandle()));
+        setPointHint(key, index);
+        return index;
+    }
     
     while(!(index->checkCordInTile(key))){
         if(!index->checkYCordInTile(key)){
@@ -617,6 +603,7 @@ Tile *LFLegaliser::findPoint(const Cord &key) const{
         }
     }
     
+    setPointHint(key, index);
     return index;
 }
 
@@ -626,6 +613,10 @@ Tile *LFLegaliser::findPoint(const Cord &key, Tile *initTile) const{
     assert(key.y < getCanvasHeight());
 
     Tile *index = initTile;
+
+    if(tilePlaneActive()){
+        return mTilePlane.getTile(mTilePlane.findPoint(key, index->getHandle()));
+    }
     
     while(!(index->checkCordInTile(key))){
         if(!index->checkYCordInTile(key)){
@@ -653,6 +644,10 @@ Tile *LFLegaliser::findPoint(const Cord &key, Tile *initTile) const{
 }
 
 void LFLegaliser::findTopNeighbors(Tile *centre, std::vector<Tile *> &neighbors) const{
+    if(tilePlaneActive()){
+        mTilePlane.findTopNeighbors(centre->getHandle(), neighbors);
+        return;
+    }
     if(centre->rt == nullptr) return;
     Tile *n = centre->rt;
     while(n->getLowerLeft().x > centre->getLowerLeft().x){
@@ -663,6 +658,10 @@ void LFLegaliser::findTopNeighbors(Tile *centre, std::vector<Tile *> &neighbors)
 }
 
 void LFLegaliser::findDownNeighbors(Tile *centre, std::vector<Tile *> &neighbors) const{
+    if(tilePlaneActive()){
+        mTilePlane.findDownNeighbors(centre->getHandle(), neighbors);
+        return;
+    }
     if(centre->lb == nullptr) return;
     Tile *n = centre->lb;
     while(n->getUpperRight().x < centre->getUpperRight().x){
@@ -673,6 +672,10 @@ void LFLegaliser::findDownNeighbors(Tile *centre, std::vector<Tile *> &neighbors
 }
 
 void LFLegaliser::findLeftNeighbors(Tile *centre, std::vector<Tile *> &neighbors) const{
+    if(tilePlaneActive()){
+        mTilePlane.findLeftNeighbors(centre->getHandle(), neighbors);
+        return;
+    }
     if(centre->bl == nullptr) return;
     Tile *n = centre->bl;
     while(n->getUpperRight().y < centre->getUpperRight().y){
@@ -683,6 +686,10 @@ void LFLegaliser::findLeftNeighbors(Tile *centre, std::vector<Tile *> &neighbors
 }
 
 void LFLegaliser::findRightNeighbors(Tile *centre, std::vector<Tile *> &neighbors) const{
+    if(tilePlaneActive()){
+        mTilePlane.findRightNeighbors(centre->getHandle(), neighbors);
+        return;
+    }
     if(centre->tr == nullptr) return;
     Tile *n = centre->tr;
     // the last neighbor is the first tile encountered whose lower y cord <= lower y cord of starting tile
@@ -701,6 +708,13 @@ void LFLegaliser::findAllNeighbors(Tile *centre, std::vector<Tile *> &neighbors)
     findRightNeighbors(centre, neighbors);
 }
 
+Tile *LFLegaliser::nextLeftEdgeTile(Tile *current, len_t x) const{
+    // the tile below "current" along x = x, lb holds the point right below the lower-left corner of "current",
+    // so only a short walk right is needed
+    if(current->lb == nullptr) return nullptr;
+    return findPoint(Cord(x, current->getLowerLeft().y - 1), current->lb);
+}
+
 bool LFLegaliser::searchArea(Cord lowerleft, len_t width, len_t height, Tile &target) const{
 
     assert(checkTesseraInCanvas(lowerleft, width, height));
@@ -710,7 +724,7 @@ bool LFLegaliser::searchArea(Cord lowerleft, len_t width, len_t height, Tile &ta
     Tile *currentFind = findPoint(Cord(lowerleft.x, searchRBorderHeight));
     std::cout << "Init found:" <<std::endl;
 
-    while(currentFind->getUpperLeft().y > lowerleft.y){
+    while(currentFind != nullptr && currentFind->getUpperLeft().y > lowerleft.y){
         // See if the tile is solid
         if(currentFind->getType() != tileType::BLANK){
             // This is an edge of a solid tile
@@ -722,10 +736,7 @@ bool LFLegaliser::searchArea(Cord lowerleft, len_t width, len_t height, Tile &ta
             return true;
         }else{
             // Move down to the next tile touching the left edge of AOI
-            if(currentFind->getLowerLeft().y <= 1){
-                break;
-            }
-            currentFind = findPoint(Cord(lowerleft.x, currentFind->getLowerLeft().y -1));
+            currentFind = nextLeftEdgeTile(currentFind, lowerleft.x);
         }
     }
 
@@ -737,7 +748,7 @@ bool LFLegaliser::searchArea(Cord lowerleft, len_t width, len_t height) const{
     len_t searchRBorderHeight = lowerleft.y + height - 1;
     Tile *currentFind = findPoint(Cord(lowerleft.x, searchRBorderHeight));
     
-    while(currentFind->getUpperLeft().y > lowerleft.y){
+    while(currentFind != nullptr && currentFind->getUpperLeft().y > lowerleft.y){
         // See if the tile is solid
         if(currentFind->getType() != tileType::BLANK){
             // This is an edge of a solid tile
@@ -746,10 +757,7 @@ bool LFLegaliser::searchArea(Cord lowerleft, len_t width, len_t height) const{
             // See if the right edge within AOI, right must be a tile
             return true;
         }else{
-            if(currentFind->getLowerLeft().y <= 1){
-                break;
-            }
-            currentFind = findPoint(Cord(lowerleft.x, currentFind->getLowerLeft().y -1));
+            currentFind = nextLeftEdgeTile(currentFind, lowerleft.x);
         }
     }
 
@@ -757,48 +765,70 @@ bool LFLegaliser::searchArea(Cord lowerleft, len_t width, len_t height) const{
 }
 
 void LFLegaliser::enumerateDirectArea(Cord lowerleft, len_t width, len_t height, std::vector <Tile *> &allTiles) const{
-    len_t searchRBorderHeight = lowerleft.y + height - 1;
-    Tile *leftTouchTile = findPoint(Cord(lowerleft.x, searchRBorderHeight));
-
-    
-    while(leftTouchTile->getUpperLeft().y > lowerleft.y){
-        enumerateDirectAreaRProcess(lowerleft, width, height, allTiles, leftTouchTile);
-        if(leftTouchTile->getLowerLeft().y <= 1) break;
-        leftTouchTile = findPoint(Cord(lowerleft.x, leftTouchTile->getLowerLeft().y -1));
-    }
+    enumerateDirectArea(lowerleft, width, height, [&allTiles](Tile *t){
+        // R1) Enumerate the tile
+        if(t->getType() == tileType::BLOCK || t->getType() == tileType::OVERLAP){
+            allTiles.push_back(t);
+        }
+        return true;
+    });
 }
 
-void LFLegaliser::enumerateDirectAreaRProcess(Cord lowerleft, len_t width, len_t height, std::vector <Tile *> &allTiles, Tile *targetTile) const{
-    
-    // R1) Enumerate the tile
-    if(targetTile->getType() == tileType::BLOCK || targetTile->getType() == tileType::OVERLAP){
-        allTiles.push_back(targetTile);
-
-    }
-
-    // R2) If the right edge of the tile is outside of the seearch area, return
-    if(targetTile->getLowerRight().x >= (lowerleft.x + width)){
-        return;
-    }
-
-    // R3) Use neighbor-finding algo to locate all the tiles that touch the right side of the current tile and also intersect the search area
-    std::vector<Tile *> rightNeighbors;
-    findRightNeighbors(targetTile, rightNeighbors);
-    for(Tile *t : rightNeighbors){
+bool LFLegaliser::enumerateDirectArea(Cord lowerleft, len_t width, len_t height, const std::function<bool(Tile *)> &visit) const{
+    len_t areaTop = lowerleft.y + height;
+    len_t areaRight = lowerleft.x + width;
 
-        // R4) If bottom left corner of the neighbor touches the current tile
-        bool R4 = targetTile->checkTRLLTouch(t);
-        // R5) If the bottom edge ofthe search area cuts both the urrent tile and the neighbor
-        bool R5 = (targetTile->cutHeight(lowerleft.y)) && (t->cutHeight(lowerleft.y));
-
-        if(R4 || R5){
-            enumerateDirectAreaRProcess(lowerleft, width, height, allTiles, t);
+    // explicit stack replacing the recursive R-process, reused between queries so they do not allocate
+    assert(!mAreaQueryActive);
+    mAreaQueryActive = true;
+    std::vector <Tile *> &stack = this->mAreaQueryStack;
+    Tile *leftTouchTile = findPoint(Cord(lowerleft.x, areaTop - 1));
+    
+    while(leftTouchTile != nullptr && leftTouchTile->getUpperLeft().y > lowerleft.y){
+        stack.clear();
+        stack.push_back(leftTouchTile);
+
+        while(!stack.empty()){
+            Tile *targetTile = stack.back();
+            stack.pop_back();
+
+            // R1) Enumerate the tile
+            if(!visit(targetTile)){
+                stack.clear();
+                mAreaQueryActive = false;
+                return false;
+            }
+
+            // R2) If the right edge of the tile is outside of the seearch area, skip its neighbors
+            if(targetTile->getLowerRight().x >= areaRight) continue;
+
+            // R3) Walk the tiles touching the right side of the current tile, top to bottom, and keep those that intersect the search area.
+            //     They are pushed in reverse so the topmost one is processed first, same order as the recursion
+            size_t firstPushed = stack.size();
+            for(Tile *t = targetTile->tr; t != nullptr && t->getUpperLeft().y > targetTile->getLowerLeft().y; t = t->lb){
+                if(t->getLowerLeft().y >= areaTop || t->getUpperLeft().y <= lowerleft.y) continue;
+
+                // R4) If bottom left corner of the neighbor touches the current tile
+                // R5) If the bottom edge of the search area crosses the neighbor and the current tile holds that edge
+                // both reduce to: the current tile spans the height where the neighbor enters the search area
+                len_t enterY = std::max(t->getLowerLeft().y, lowerleft.y);
+                bool R4R5 = (targetTile->getLowerLeft().y <= enterY) && (enterY < targetTile->getUpperLeft().y);
+
+                if(R4R5){
+                    stack.push_back(t);
+                }
+            }
+            std::reverse(stack.begin() + firstPushed, stack.end());
         }
-    }
 
+        leftTouchTile = nextLeftEdgeTile(leftTouchTile, lowerleft.x);
+    }
+    mAreaQueryActive = false;
+    return true;
 }
 
 void LFLegaliser::insertFirstTile(Tile &newTile){
+    touchPlane();
     assert(this->checkTileInCanvas(newTile));
     // cut the canvas into four parts: above, below, left, rifht
     
@@ -810,19 +840,19 @@ void LFLegaliser::insertFirstTile(Tile &newTile){
 
 
     if(hasDownTile){
-        tdown = new Tile(tileType::BLANK, Cord(0,0),
+        tdown = mTilePool.allocate(tileType::BLANK, Cord(0,0),
                             this->mCanvasWidth, newTile.getLowerLeft().y);
         newTile.lb = tdown;
     }
 
     if(hasUpTile){
-        tup = new Tile(tileType::BLANK, Cord(0,newTile.getUpperRight().y), 
+        tup = mTilePool.allocate(tileType::BLANK, Cord(0,newTile.getUpperRight().y), 
                             this->mCanvasWidth, (this->mCanvasHeight - newTile.getUpperRight().y));
         newTile.rt = tup;
     }
 
     if(hasLeftTile){
-        tleft = new Tile(tileType::BLANK, Cord(0, newTile.getLowerLeft().y),
+        tleft = mTilePool.allocate(tileType::BLANK, Cord(0, newTile.getLowerLeft().y),
                             newTile.getLowerLeft().x, (newTile.getUpperLeft().y - newTile.getLowerLeft().y));
         newTile.bl = tleft;
         tleft->tr = &newTile;
@@ -837,7 +867,7 @@ void LFLegaliser::insertFirstTile(Tile &newTile){
     }
 
     if(hasRightTile){
-        tright = new Tile(tileType::BLANK, newTile.getLowerRight(), 
+        tright = mTilePool.allocate(tileType::BLANK, newTile.getLowerRight(), 
                             (this->mCanvasWidth - newTile.getUpperRight().x), (newTile.getUpperLeft().y - newTile.getLowerLeft().y));
         newTile.tr = tright;
         tright->bl = &newTile;
@@ -850,9 +880,11 @@ void LFLegaliser::insertFirstTile(Tile &newTile){
         if(hasDownTile) tdown->rt = &newTile;
     }
 
+    setPointHint(newTile.getLowerLeft(), &newTile);
 }
 
 void LFLegaliser::insertTile(Tile &tile){
+    touchPlane();
     // assert(checkTesseraInCanvas(tile.getLowerLeft(), tile.getWidth(), tile.getHeight()));
     if (!checkTesseraInCanvas(tile.getLowerLeft(), tile.getWidth(), tile.getHeight())) {
         throw "assert(checkTesseraInCanvas(tile.getLowerLeft(), tile.getWidth(), tile.getHeight()))";
@@ -862,6 +894,7 @@ void LFLegaliser::insertTile(Tile &tile){
     if (searchArea(tile.getLowerLeft(), tile.getWidth(), tile.getHeight())) {
         throw "assert(!searchArea(tile.getLowerLeft(), tile.getWidth(), tile.getHeight()))";
     }
+    journalEdit(tile.getLowerLeft(), tile.getWidth(), tile.getHeight());
 
 
     /* STEP 1) Find the space Tile containing the top edge of the aera to be occupied, process */
@@ -877,7 +910,7 @@ void LFLegaliser::insertTile(Tile &tile){
     if((!tileTouchesSky)&&(!cleanTopCut)){
 
         
-        Tile *newDown = new Tile(tileType::BLANK, origTop->getLowerLeft(),origTop->getWidth(), (tile.getUpperLeft().y - origTop->getLowerLeft().y));
+        Tile *newDown = mTilePool.allocate(tileType::BLANK, origTop->getLowerLeft(),origTop->getWidth(), (tile.getUpperLeft().y - origTop->getLowerLeft().y));
         newDown->rt = origTop;
         newDown->lb = origTop->lb;
         newDown->bl = origTop->bl;
@@ -951,7 +984,7 @@ void LFLegaliser::insertTile(Tile &tile){
 
     if((!tileTouchesGround) && (!cleanBottomCut)){
         
-        Tile *newUp = new Tile(tileType::BLANK, Cord(origBottom->getLowerLeft().x, tile.getLowerLeft().y)
+        Tile *newUp = mTilePool.allocate(tileType::BLANK, Cord(origBottom->getLowerLeft().x, tile.getLowerLeft().y)
                                 , origBottom->getWidth(), (origBottom->getUpperLeft().y - tile.getLowerLeft().y));         
         
         newUp->rt = origBottom->rt;
@@ -1027,8 +1060,8 @@ void LFLegaliser::insertTile(Tile &tile){
     len_t findTileY = splitTile->getLowerLeft().y;
     Tile *oldsplitTile;
 
-    // Merge helping indexes
-    len_t leftMergeWidth = 0, rightMergeWidth = 0;
+    // blank pieces split off at the sides, they are the only tiles that may break the maximal strip form
+    std::vector <Tile *> mergeWorklist;
 
     bool topMostMerge = true;
     while(true){
@@ -1041,7 +1074,7 @@ void LFLegaliser::insertTile(Tile &tile){
 
         // The middle piece (must have)
         // This should change to tile.type
-        Tile *newMid = new Tile(tileType::BLANK, Cord(tileLeftBorder, splitTile->getLowerLeft().y), tile.getWidth(), splitTile->getHeight());
+        Tile *newMid = mTilePool.allocate(tileType::BLANK, Cord(tileLeftBorder, splitTile->getLowerLeft().y), tile.getWidth(), splitTile->getHeight());
         newMid->bl = splitTile->bl;
         newMid->tr = splitTile->tr;
 
@@ -1057,7 +1090,7 @@ void LFLegaliser::insertTile(Tile &tile){
         // split the left piece if necessary, maintain tr, bl pointer integrity
         bool leftSplitNecessary = (blankLeftBorder != tileLeftBorder);
         if(leftSplitNecessary){
-            Tile *newLeft = new Tile(tileType::BLANK, splitTile->getLowerLeft(),(tileLeftBorder - blankLeftBorder) ,splitTile->getHeight());
+            Tile *newLeft = mTilePool.allocate(tileType::BLANK, splitTile->getLowerLeft(),(tileLeftBorder - blankLeftBorder) ,splitTile->getHeight());
             // visualiseAddMark(newLeft);
             newLeft->tr = newMid;
             newLeft->bl = splitTile->bl;
@@ -1116,7 +1149,7 @@ void LFLegaliser::insertTile(Tile &tile){
         // split the right piece if necessary, maintain tr, bl pointer integrity
         bool rightSplitNecessary = (tileRightBorder != blankRightBorder);
         if(rightSplitNecessary){
-            Tile *newRight = new Tile(tileType::BLANK, newMid->getLowerRight(),(blankRightBorder- tileRightBorder) ,newMid->getHeight());
+            Tile *newRight = mTilePool.allocate(tileType::BLANK, newMid->getLowerRight(),(blankRightBorder- tileRightBorder) ,newMid->getHeight());
             // visualiseAddMark(newRight);
             newRight->tr = splitTile->tr;
             newRight->bl = newMid;
@@ -1204,121 +1237,9 @@ void LFLegaliser::insertTile(Tile &tile){
         }
 
 
-        // Start Merging process
-        
-        // Merge the left blocks if necessary
-        bool initTopLeftMerge = false;
-        if(topMostMerge){
-            Tile *initTopLeftUp, *initTopLeftDown;
-            if(leftSplitNecessary){
-                
-                initTopLeftDown = newMid->bl;
-                if(initTopLeftDown->rt != nullptr){
-                    initTopLeftUp= initTopLeftDown->rt;
-                    bool sameWidth = (initTopLeftUp->getWidth() == initTopLeftDown->getWidth());
-                    bool xAligned = (initTopLeftUp->getLowerLeft().x == initTopLeftDown->getLowerLeft().x);
-                    if((initTopLeftUp->getType() == tileType::BLANK) &&  sameWidth && xAligned){
-                        initTopLeftMerge = true;
-                    }
-                }
-            }
-        }
-
-        bool leftNeedsMerge = ((leftMergeWidth != 0) && (leftMergeWidth == (tileLeftBorder - blankLeftBorder))) || initTopLeftMerge;
-        if(leftNeedsMerge){
-            Tile *mergeUp = newMid->bl->rt;
-            Tile *mergeDown = newMid->bl;
-
-            std::vector<Tile *> mergedownLeftNeighbors;
-            findLeftNeighbors(mergeDown, mergedownLeftNeighbors);
-            for(int i = 0; i < mergedownLeftNeighbors.size(); ++i){
-                if(mergedownLeftNeighbors[i]->tr == mergeDown){
-                    mergedownLeftNeighbors[i]->tr = mergeUp;
-                }
-            }
-
-            std::vector<Tile *> mergedownDownNeighbors;
-            findDownNeighbors(mergeDown, mergedownDownNeighbors);
-            for(int i = 0; i < mergedownDownNeighbors.size(); ++i){
-                if(mergedownDownNeighbors[i]->rt == mergeDown){
-                    mergedownDownNeighbors[i]->rt = mergeUp;
-                }
-            }
-            std::vector<Tile *> mergedownRightNeighbors;
-            findRightNeighbors(mergeDown, mergedownRightNeighbors);
-            for(int i = 0; i < mergedownRightNeighbors.size(); ++i){
-                if(mergedownRightNeighbors[i]->bl == mergeDown){
-                    mergedownRightNeighbors[i]->bl = mergeUp;
-                }
-            }
-            
-            mergeUp->bl = mergeDown->bl;
-            mergeUp->lb = mergeDown->lb;
-            
-            mergeUp->setLowerLeft(mergeDown->getLowerLeft());
-            mergeUp->setHeight(mergeUp->getHeight() + mergeDown->getHeight());
-            
-            delete(mergeDown);
-        }
-        // update merge width for latter blocks
-        leftMergeWidth = tileLeftBorder - blankLeftBorder;
-
-
-        // Merge the right blocks if possible
-        bool initTopRightMerge = false;
-        if(topMostMerge){
-            Tile *initTopRightUp, *initTopRightDown;
-            if(rightSplitNecessary){
-                initTopRightDown = newMid->tr;
-                if(initTopRightDown->rt != nullptr){
-                    initTopRightUp = initTopRightDown->rt;
-                    bool sameWidth = (initTopRightUp->getWidth() == initTopRightDown->getWidth());
-                    bool xAligned = (initTopRightUp->getLowerLeft().x == initTopRightDown->getLowerLeft().x);
-                    if((initTopRightUp->getType() == tileType::BLANK) && (sameWidth) && (xAligned)){
-                        initTopRightMerge = true;
-                    }
-                }
-            }
-        }
-        
-        bool rightNeedsMerge = ((rightMergeWidth != 0 ) && (rightMergeWidth == (blankRightBorder - tileRightBorder))) || initTopRightMerge;        
-        if(rightNeedsMerge){
-            Tile *mergeUp = newMid->tr->rt;
-            Tile *mergeDown = newMid->tr;
-
-            std::vector<Tile *> mergedownLeftNeighbors;
-            findLeftNeighbors(mergeDown, mergedownLeftNeighbors);
-            for(int i = 0; i < mergedownLeftNeighbors.size(); ++i){
-                if(mergedownLeftNeighbors[i]->tr == mergeDown){
-                    mergedownLeftNeighbors[i]->tr = mergeUp;
-                }
-            }
-
-            std::vector<Tile *> mergedownDownNeighbors;
-            findDownNeighbors(mergeDown, mergedownDownNeighbors);
-            for(int i = 0; i < mergedownDownNeighbors.size(); ++i){
-                if(mergedownDownNeighbors[i]->rt == mergeDown){
-                    mergedownDownNeighbors[i]->rt = mergeUp;
-                }
-            }
-            std::vector<Tile *> mergedownRightNeighbors;
-            findRightNeighbors(mergeDown, mergedownRightNeighbors);
-            for(int i = 0; i < mergedownRightNeighbors.size(); ++i){
-                if(mergedownRightNeighbors[i]->bl == mergeDown){
-                    mergedownRightNeighbors[i]->bl = mergeUp;
-                }
-            }
-            mergeUp->bl = mergeDown->bl;
-            mergeUp->lb = mergeDown->lb;
-            
-            mergeUp->setLowerLeft(mergeDown->getLowerLeft());
-            mergeUp->setHeight(mergeUp->getHeight() + mergeDown->getHeight());
-            
-            delete(mergeDown);
-        }
-        // update right merge width for latter blocks
-        rightMergeWidth = blankRightBorder - tileRightBorder;
-
+        // left and right pieces are merged with the blanks above and below once the tile is in place
+        if(leftSplitNecessary) mergeWorklist.push_back(newMid->bl);
+        if(rightSplitNecessary) mergeWorklist.push_back(newMid->tr);
 
         // Finally, merge the middle tile, it MUST merge after the first time
         
@@ -1354,113 +1275,13 @@ void LFLegaliser::insertTile(Tile &tile){
             mergeUp->setLowerLeft(mergeDown->getLowerLeft());
             mergeUp->setHeight(mergeUp->getHeight() + mergeDown->getHeight());
             
-            delete(mergeDown);
+            mTilePool.release(mergeDown);
             // link newMid back
             newMid = mergeUp;
         }
 
         oldsplitTile = splitTile;
         if(findTileY == tile.getLowerLeft().y){
-            // Merging the bottom most split blank tile and the blank tile below if necessary
-
-            // Detect & Merging left bottom & the blank below
-            bool lastDownLeftMerge = false;
-            Tile *lastBotLeftUp, *lastBotLeftDown;
-            if(leftSplitNecessary){
-                lastBotLeftUp = newMid->bl;
-                if(lastBotLeftUp->lb != nullptr){
-                    lastBotLeftDown = lastBotLeftUp->lb;
-                    bool sameWidth = (lastBotLeftUp->getWidth() == lastBotLeftDown->getWidth());
-                    bool xAligned = (lastBotLeftUp->getLowerLeft().x == lastBotLeftDown->getLowerLeft().x);
-                    if(lastBotLeftUp->getType() == tileType::BLANK && lastBotLeftDown->getType() == tileType::BLANK && sameWidth && xAligned){
-                        lastDownLeftMerge = true;
-                    }
-                }
-            }
-
-            if(lastDownLeftMerge){
-                std::vector<Tile *> mergedownLeftNeighbors;
-                findLeftNeighbors(lastBotLeftDown, mergedownLeftNeighbors);
-                for(int i = 0; i < mergedownLeftNeighbors.size(); ++i){
-                    if(mergedownLeftNeighbors[i]->tr == lastBotLeftDown){
-                        mergedownLeftNeighbors[i]->tr = lastBotLeftUp;
-                    }
-                }
-
-                std::vector<Tile *> mergedownDownNeighbors;
-                findDownNeighbors(lastBotLeftDown, mergedownDownNeighbors);
-                for(int i = 0; i < mergedownDownNeighbors.size(); ++i){
-                    if(mergedownDownNeighbors[i]->rt == lastBotLeftDown){
-                        mergedownDownNeighbors[i]->rt = lastBotLeftUp;
-                    }
-                }
-                std::vector<Tile *> mergedownRightNeighbors;
-                findRightNeighbors(lastBotLeftDown, mergedownRightNeighbors);
-                for(int i = 0; i < mergedownRightNeighbors.size(); ++i){
-                    if(mergedownRightNeighbors[i]->bl == lastBotLeftDown){
-                        mergedownRightNeighbors[i]->bl = lastBotLeftUp;
-                    }
-                }
-
-                lastBotLeftUp->bl = lastBotLeftDown->bl;
-                lastBotLeftUp->lb = lastBotLeftDown->lb;
-
-                lastBotLeftUp->setLowerLeft(lastBotLeftDown->getLowerLeft());
-                lastBotLeftUp->setHeight(lastBotLeftUp->getHeight() + lastBotLeftDown->getHeight());
-
-                delete(lastBotLeftDown);
-            }
-
-            
-            // Detect & Merging right bottom & the blank below            
-
-            bool lastDownRightmerge = false;
-            Tile *lastBotRightUp, *lastBotRightDown;
-            if(rightSplitNecessary){
-                lastBotRightUp = newMid->tr;
-                if(lastBotRightUp->lb != nullptr){
-                    lastBotRightDown = lastBotRightUp->lb;
-                    bool sameWidth = (lastBotRightUp->getWidth() == lastBotRightDown->getWidth());
-                    bool xAligned = (lastBotRightUp->getLowerLeft().x == lastBotRightDown->getLowerLeft().x);
-                    if(lastBotRightUp->getType() == tileType::BLANK && lastBotRightDown->getType() == tileType::BLANK && sameWidth && xAligned){
-                        lastDownRightmerge = true;
-                    }
-
-                }
-            }
-
-            if(lastDownRightmerge){
-                std::vector<Tile *> mergedownLeftNeighbors;
-                findLeftNeighbors(lastBotRightDown, mergedownLeftNeighbors);
-                for(int i = 0; i < mergedownLeftNeighbors.size(); ++i){
-                    if(mergedownLeftNeighbors[i]->tr == lastBotRightDown){
-                        mergedownLeftNeighbors[i]->tr = lastBotRightUp;
-                    }
-                }
-
-                std::vector<Tile *> mergedownDownNeighbors;
-                findDownNeighbors(lastBotRightDown, mergedownDownNeighbors);
-                for(int i = 0; i < mergedownDownNeighbors.size(); ++i){
-                    if(mergedownDownNeighbors[i]->rt == lastBotRightDown){
-                        mergedownDownNeighbors[i]->rt = lastBotRightUp;
-                    }
-                }
-                std::vector<Tile *> mergedownRightNeighbors;
-                findRightNeighbors(lastBotRightDown, mergedownRightNeighbors);
-                for(int i = 0; i < mergedownRightNeighbors.size(); ++i){
-                    if(mergedownRightNeighbors[i]->bl == lastBotRightDown){
-                        mergedownRightNeighbors[i]->bl = lastBotRightUp;
-                    }
-                }
-                lastBotRightUp->bl = lastBotRightDown->bl;
-                lastBotRightUp->lb = lastBotRightDown->lb;
-                
-                lastBotRightUp->setLowerLeft(lastBotRightDown->getLowerLeft());
-                lastBotRightUp->setHeight(lastBotRightUp->getHeight() + lastBotRightDown->getHeight());
-                
-                delete(lastBotRightDown);
-            }
-            
             // substitute the middle tile with the input "tile"
             tile.rt = newMid->rt;
             tile.tr = newMid->tr;
@@ -1502,19 +1323,23 @@ void LFLegaliser::insertTile(Tile &tile){
                 }
             }
 
-            delete(newMid);
-            delete(oldsplitTile);
+            mTilePool.release(newMid);
+            mTilePool.release(oldsplitTile);
 
+            setPointHint(tile.getLowerLeft(), &tile);
             break;
         }else{
-            splitTile = findPoint(Cord(tile.getLowerLeft().x, findTileY) - Cord(0,1));
+            // the next blank holds the point right below the lower-left corner of newMid, start the walk there
+            splitTile = findPoint(Cord(tile.getLowerLeft().x, findTileY) - Cord(0,1), newMid);
             findTileY= splitTile->getLowerLeft().y;
-            delete(oldsplitTile);
+            mTilePool.release(oldsplitTile);
         }
 
         // mark this is not the top most merge
         topMostMerge = false;
     }
+
+    mergeBlankStrips(mergeWorklist);
     
 }
 
@@ -1563,20 +1388,26 @@ void LFLegaliser::visualiseArtpiece(const std::string outputFileName, bool check
     // Bug found, 8/1, 2023
     // Warning!! At this stage, no Empty tiles are created, DFS would cause error to the markings of tiles.
 
-    std::vector <Cord> record;
+    auto printBlank = [&ofs](Tile *t){
+        if(t->getType() == tileType::BLANK){
+            ofs << t->getLowerLeft().x << " " << t->getLowerLeft().y << " ";
+            ofs << t->getWidth() << " " << t->getHeight() << " ";
+            ofs << "BLANK_TILE" << std::endl;
+        }
+    };
 
     if(checkBlankTile){
         if(fixedTesserae.size() !=0 ){
             if(this->fixedTesserae[0]->TileArr.size() != 0){
-                traverseBlank(ofs, *(this->fixedTesserae[0]->TileArr[0]), record);
+                enumerateAllTiles(this->fixedTesserae[0]->TileArr[0], printBlank);
             }else{
-                traverseBlank(ofs, *(this->fixedTesserae[0]->OverlapArr[0]), record);
+                enumerateAllTiles(this->fixedTesserae[0]->OverlapArr[0], printBlank);
             }
         }else{
             if(softTesserae.size() != 0){
-                traverseBlank(ofs, *(this->softTesserae[0]->TileArr[0]), record);
+                enumerateAllTiles(this->softTesserae[0]->TileArr[0], printBlank);
             }else{
-                traverseBlank(ofs, *(this->softTesserae[0]->OverlapArr[0]), record);
+                enumerateAllTiles(this->softTesserae[0]->OverlapArr[0], printBlank);
             }
         }
     }
@@ -1590,44 +1421,6 @@ void LFLegaliser::visualiseArtpiece(const std::string outputFileName, bool check
     ofs.close();
 }
 
-void LFLegaliser::traverseBlank(std::ofstream &ofs,  Tile &t, std::vector <Cord> &record) {
-
-    record.push_back(t.getLowerLeft());
-    
-    if(t.getType() == tileType::BLANK){
-
-        ofs << t.getLowerLeft().x << " " << t.getLowerLeft().y << " ";
-        ofs << t.getWidth() << " " << t.getHeight() << " ";
-        ofs << "BLANK_TILE" << std::endl;
-    }
-
-    if(t.rt != nullptr){        
-        if(!checkVectorInclude(record, t.rt->getLowerLeft())){
-            traverseBlank(ofs, *(t.rt), record);
-        }
-    }
-
-    if(t.lb != nullptr){
-        if(!checkVectorInclude(record, t.lb->getLowerLeft())){
-            traverseBlank(ofs, *(t.lb), record);
-        }
-    }
-
-    if(t.bl != nullptr){
-        if(!checkVectorInclude(record, t.bl->getLowerLeft())){
-            traverseBlank(ofs, *(t.bl), record);
-        }
-    }
-
-    if(t.tr != nullptr){
-        if(!checkVectorInclude(record,t.tr->getLowerLeft())){
-            traverseBlank(ofs, *(t.tr), record);
-        }
-    }
-    
-    return;
-}
-
 void LFLegaliser::visualiseAddMark(Tile * markTile){
     this->mMarkedTiles.push_back(markTile);
 }
@@ -1639,7 +1432,9 @@ void LFLegaliser::visualiseRemoveAllmark(){
 
 void LFLegaliser::arrangeTesseraetoCanvas(){
 
-    std::vector <Cord> record;
+    // tiles collected in this call carry the current epoch, overlap tiles are shared between tesserae and painted once
+    unsigned long long paintEpoch = nextVisitEpoch();
+    std::vector <Tile *> solids;
     
     std::cout << "Painting Fixed Tessera to Canvas:" << std::endl;
     for(Tessera *tess : this->fixedTesserae){
@@ -1651,32 +1446,22 @@ void LFLegaliser::arrangeTesseraetoCanvas(){
         }
 
         for(Tile *tile : tess->TileArr){
-            assert(!checkVectorInclude(record, tile->getLowerLeft()));
-
-            if(record.empty()) insertFirstTile(*tile);
-            else insertTile(*tile);
-
-            record.push_back(tile->getLowerLeft());
+            assert(tile->visitStamp != paintEpoch);
+            tile->visitStamp = paintEpoch;
+            solids.push_back(tile);
         }
         
         for(Tile *tile : tess->OverlapArr){
             // for overlap tiles, only push when it's never met
-            if(!checkVectorInclude(record, tile->getLowerLeft()) && (tile->getWidth() != 0) && (tile->getHeight() != 0)){
-                
-                if(record.empty()) insertFirstTile(*tile);
-                else insertTile(*tile);
-                
-                record.push_back(tile->getLowerLeft());
+            if((tile->visitStamp != paintEpoch) && (tile->getWidth() != 0) && (tile->getHeight() != 0)){
+                tile->visitStamp = paintEpoch;
+                solids.push_back(tile);
             }
         }
     }
 
-    // visualiseDebug("outputs/debug.txt");
     std::cout << "Painting Soft Tessera to Canvas:" << std::endl;
-    Tessera *tess;
-    for(int i = 0; i < this->softTesserae.size(); ++i){
-        tess = this->softTesserae[i];
-
+    for(Tessera *tess : this->softTesserae){
         std::cout << tess->getName()<<": Tiles->" << tess->TileArr.size() << ", Overlaps->" << tess->OverlapArr.size() << std::endl;
         
         // added by ryan
@@ -1684,33 +1469,218 @@ void LFLegaliser::arrangeTesseraetoCanvas(){
             continue;
         }
 
-        Tile *tile;
-        for(int j = 0; j < tess->TileArr.size(); ++j){
-            tile = tess->TileArr[j];
-            assert(!checkVectorInclude(record, tile->getLowerLeft()));
+        for(Tile *tile : tess->TileArr){
+            assert(tile->visitStamp != paintEpoch);
+            tile->visitStamp = paintEpoch;
+            solids.push_back(tile);
+        }
+        for(Tile *tile : tess->OverlapArr){
+            // for overlap tiles, only push when it's never met
+            if((tile->visitStamp != paintEpoch) && (tile->getWidth() != 0) && (tile->getHeight() != 0)){
+                tile->visitStamp = paintEpoch;
+                solids.push_back(tile);
+            }
+        }
+    }
 
-            if(record.empty()) insertFirstTile(*tile);
-            else insertTile(*tile);
+    buildPlane(solids);
+}
+
+void LFLegaliser::buildPlane(const std::vector<Tile *> &solids){
+    touchPlane();
+    if(solids.empty()) return;
+
+    for(Tile *tile : solids){
+        if (!checkTesseraInCanvas(tile->getLowerLeft(), tile->getWidth(), tile->getHeight())) {
+            throw "assert(checkTesseraInCanvas(tile->getLowerLeft(), tile->getWidth(), tile->getHeight()))";
+        }
+        tile->rt = tile->tr = tile->bl = tile->lb = nullptr;
+    }
+
+    // solids ordered by bottom edge (starting) and by top edge (ending)
+    std::vector <Tile *> byBottom(solids.begin(), solids.end());
+    std::sort(byBottom.begin(), byBottom.end(), [](Tile *a, Tile *b){
+        if(a->getLowerLeft().y != b->getLowerLeft().y) return a->getLowerLeft().y < b->getLowerLeft().y;
+        return a->getLowerLeft().x < b->getLowerLeft().x;
+    });
+    std::vector <Tile *> byTop(solids.begin(), solids.end());
+    std::sort(byTop.begin(), byTop.end(), [](Tile *a, Tile *b){
+        return a->getUpperRight().y < b->getUpperRight().y;
+    });
+
+    std::vector <len_t> events;
+    events.reserve(2 * solids.size() + 2);
+    events.push_back(0);
+    events.push_back(mCanvasHeight);
+    for(Tile *tile : solids){
+        events.push_back(tile->getLowerLeft().y);
+        events.push_back(tile->getUpperRight().y);
+    }
+    std::sort(events.begin(), events.end());
+    events.erase(std::unique(events.begin(), events.end()), events.end());
+
+    // the partition of the current horizontal band into tiles, keyed by the left border of each tile
+    std::map <len_t, Tile *> band;
+    auto containing = [&band](len_t x) -> Tile *{
+        auto it = band.upper_bound(x);
+        assert(it != band.begin());
+        return std::prev(it)->second;
+    };
 
-            record.push_back(tile->getLowerLeft());
+    std::vector <Tile *> starting, ending, removed, newBand;
+    std::vector <std::pair<len_t, len_t>> dirty;
+    int bottomIdx = 0, topIdx = 0;
+
+    for(len_t y : events){
+        starting.clear();
+        ending.clear();
+        removed.clear();
+        newBand.clear();
+        dirty.clear();
+
+        while(topIdx < byTop.size() && byTop[topIdx]->getUpperRight().y == y){
+            ending.push_back(byTop[topIdx]);
+            dirty.push_back(std::make_pair(byTop[topIdx]->getLowerLeft().x, byTop[topIdx]->getLowerRight().x));
+            topIdx++;
+        }
+        std::vector <Tile *> startingSolids;
+        while(bottomIdx < byBottom.size() && byBottom[bottomIdx]->getLowerLeft().y == y){
+            Tile *tile = byBottom[bottomIdx];
+            if(!startingSolids.empty() && startingSolids.back()->getLowerRight().x > tile->getLowerLeft().x){
+                throw "buildPlane: overlapping solid tiles";
+            }
+            startingSolids.push_back(tile);
+            dirty.push_back(std::make_pair(tile->getLowerLeft().x, tile->getLowerRight().x));
+            bottomIdx++;
+        }
+
+        if(y == mCanvasHeight){
+            // every tile left in the band ends at the top of the canvas
+            for(auto it = band.begin(); it != band.end(); ++it){
+                Tile *tile = it->second;
+                auto next = std::next(it);
+                tile->tr = (next == band.end())? nullptr : next->second;
+                if(tile->getType() == tileType::BLANK){
+                    tile->setHeight(y - tile->getLowerLeft().y);
+                }
+            }
+            break;
+        }
+
+        // 1. collect the tiles of the old band whose span changes at y, they form runs bounded by continuing solids
+        std::vector <std::pair<len_t, len_t>> runs;
+        if(band.empty()){
+            runs.push_back(std::make_pair(0, mCanvasWidth));
+        }else{
+            unsigned long long removeEpoch = nextVisitEpoch();
+            auto include = [&](Tile *tile){
+                if(tile->visitStamp == removeEpoch) return;
+                tile->visitStamp = removeEpoch;
+                removed.push_back(tile);
+            };
+            for(const std::pair<len_t, len_t> &d : dirty){
+                auto it = std::prev(band.upper_bound(d.first));
+                if(it != band.begin() && std::prev(it)->second->getType() == tileType::BLANK){
+                    include(std::prev(it)->second);
+                }
+                for(; it != band.end() && it->first < d.second; ++it){
+                    Tile *tile = it->second;
+                    bool isEnding = (tile->getType() != tileType::BLANK) && (tile->getUpperRight().y == y);
+                    if(tile->getType() != tileType::BLANK && !isEnding){
+                        throw "buildPlane: overlapping solid tiles";
+                    }
+                    include(tile);
+                }
+                if(it != band.end() && it->second->getType() == tileType::BLANK){
+                    include(it->second);
+                }
+            }
+            std::sort(removed.begin(), removed.end(), [](Tile *a, Tile *b){
+                return a->getLowerLeft().x < b->getLowerLeft().x;
+            });
+            for(Tile *tile : removed){
+                if(!runs.empty() && runs.back().second == tile->getLowerLeft().x){
+                    runs.back().second = tile->getLowerRight().x;
+                }else{
+                    runs.push_back(std::make_pair(tile->getLowerLeft().x, tile->getLowerRight().x));
+                }
+            }
         }
-        for(int j = 0; j < tess->OverlapArr.size(); ++j){
-            // for overlap tiles, only push when it's never met
-            tile = tess->OverlapArr[j];
-            if(!checkVectorInclude(record, tile->getLowerLeft()) && (tile->getWidth() != 0) && (tile->getHeight() != 0)){
-                if(record.empty()) insertFirstTile(*tile);
-                else insertTile(*tile);
 
-                record.push_back(tile->getLowerLeft());
+        // 2. refill every run with the starting solids and maximal blanks, a blank with an unchanged span continues upward
+        std::map <std::pair<len_t, len_t>, Tile *> oldBlanks;
+        for(Tile *tile : removed){
+            if(tile->getType() == tileType::BLANK){
+                oldBlanks[std::make_pair(tile->getLowerLeft().x, tile->getLowerRight().x)] = tile;
+            }
+        }
+        auto fillBlank = [&](len_t xl, len_t xh){
+            auto found = oldBlanks.find(std::make_pair(xl, xh));
+            if(found != oldBlanks.end()){
+                newBand.push_back(found->second);
+                oldBlanks.erase(found);
+            }else{
+                Tile *blank = mTilePool.allocate(tileType::BLANK, Cord(xl, y), xh - xl, 0);
+                newBand.push_back(blank);
+                starting.push_back(blank);
+            }
+        };
+        int solidIdx = 0;
+        for(const std::pair<len_t, len_t> &run : runs){
+            len_t cursor = run.first;
+            while(solidIdx < startingSolids.size() && startingSolids[solidIdx]->getLowerLeft().x < run.second){
+                Tile *tile = startingSolids[solidIdx];
+                if(tile->getLowerLeft().x < cursor){
+                    throw "buildPlane: overlapping solid tiles";
+                }
+                if(tile->getLowerLeft().x > cursor) fillBlank(cursor, tile->getLowerLeft().x);
+                newBand.push_back(tile);
+                starting.push_back(tile);
+                cursor = tile->getLowerRight().x;
+                solidIdx++;
             }
+            if(cursor > run.second){
+                throw "buildPlane: overlapping solid tiles";
+            }
+            if(cursor < run.second) fillBlank(cursor, run.second);
+        }
+        for(auto &leftover : oldBlanks){
+            Tile *tile = leftover.second;
+            tile->setHeight(y - tile->getLowerLeft().y);
+            ending.push_back(tile);
         }
 
+        // 3. stitches looking into the band below: tr of ending tiles, lb of starting tiles
+        for(Tile *tile : ending){
+            auto next = band.find(tile->getLowerRight().x);
+            tile->tr = (next == band.end())? nullptr : next->second;
+        }
+        for(Tile *tile : starting){
+            tile->lb = (y == 0)? nullptr : containing(tile->getLowerLeft().x);
+        }
+
+        // 4. swap in the new band, then stitches looking into it: rt of ending tiles, bl of starting tiles
+        for(Tile *tile : removed){
+            band.erase(tile->getLowerLeft().x);
+        }
+        for(Tile *tile : newBand){
+            band[tile->getLowerLeft().x] = tile;
+        }
+        for(Tile *tile : ending){
+            tile->rt = containing(tile->getLowerRight().x - 1);
+        }
+        for(Tile *tile : starting){
+            auto it = band.find(tile->getLowerLeft().x);
+            tile->bl = (it == band.begin())? nullptr : std::prev(it)->second;
+        }
     }
+
+    resetPointHints();
+    enumerateAllTiles(solids[0], [this](Tile *t){ setPointHint(t->getLowerLeft(), t); });
 }
 
 void LFLegaliser::visualiseDebug(const std::string outputFileName){
 
-    std::vector <Cord> record;
     std::cout << "print DEBUGS to file..."<< outputFileName <<std::endl;
 
     std::ofstream ofs(outputFileName);
@@ -1722,196 +1692,362 @@ void LFLegaliser::visualiseDebug(const std::string outputFileName){
         return;
     }
 
+    auto printTile = [&ofs](Tile *t){
+        ofs << t->getLowerLeft().x << " " << t->getLowerLeft().y << " " << t->getWidth() << " " << t->getHeight() << " ";
+        if(t->getType() == tileType::BLOCK){
+            ofs << "BLOCK";
+        }else if(t->getType() == tileType::OVERLAP){
+            ofs << "OVERLAP";
+        }else if(t->getType() == tileType::BLANK){
+            ofs << "BLANK_TILE";
+        }else{
+            ofs << "ERRRRRRRRRRRRRRRRRRRRRRRRRRRRRRRROOOOOOOOOOOORRR";
+        }
+        ofs << std::endl;
+        t->show(ofs);
+        t->showLink(ofs);
+    };
+
     if(fixedTesserae.size() !=0 ){
         if(this->fixedTesserae[0]->TileArr.size() != 0){
-            visualiseDebugDFS(ofs, *(this->fixedTesserae[0]->TileArr[0]), record);
+            enumerateAllTiles(this->fixedTesserae[0]->TileArr[0], printTile);
         }else{
-            visualiseDebugDFS(ofs, *(this->fixedTesserae[0]->OverlapArr[0]), record);
+            enumerateAllTiles(this->fixedTesserae[0]->OverlapArr[0], printTile);
         }
     }else{
         if(softTesserae.size() != 0){
-            visualiseDebugDFS(ofs, *(this->softTesserae[0]->TileArr[0]), record);
+            enumerateAllTiles(this->softTesserae[0]->TileArr[0], printTile);
         }else{
-            visualiseDebugDFS(ofs, *(this->softTesserae[0]->OverlapArr[0]), record);
+            enumerateAllTiles(this->softTesserae[0]->OverlapArr[0], printTile);
         }
     }
     ofs.close();
 
 }
 
-void LFLegaliser::visualiseDebugDFS(std::ofstream &ofs, Tile &t, std::vector <Cord> &record){
-    
-    record.push_back(t.getLowerLeft());
-    
-    ofs << t.getLowerLeft().x << " " << t.getLowerLeft().y << " " << t.getWidth() << " " << t.getHeight() << " ";
-    if(t.getType() == tileType::BLOCK){
-        ofs << "BLOCK";
-    }else if(t.getType() == tileType::OVERLAP){
-        ofs << "OVERLAP";
-    }else if(t.getType() == tileType::BLANK){
-        ofs << "BLANK_TILE";
-    }else{
-        ofs << "ERRRRRRRRRRRRRRRRRRRRRRRRRRRRRRRROOOOOOOOOOOORRR";
+void LFLegaliser::combineVerticalMergeableBlanks(Tile *upTile, Tile *downTile){
+    touchPlane();
+    std::vector <Tile *> mergeUpUpNeighbors;
+    findTopNeighbors(upTile, mergeUpUpNeighbors);
+    for(Tile *t : mergeUpUpNeighbors){
+        if(t->lb == upTile) t->lb = downTile;
     }
-    ofs << std::endl;
-    t.show(ofs);
-    t.showLink(ofs);
 
-    if(t.rt != nullptr){
-        if(!checkVectorInclude(record,t.rt->getLowerLeft())){
-            visualiseDebugDFS(ofs, *(t.rt), record);
-        }
+    std::vector <Tile *> mergeUpLeftNeighbors;
+    findLeftNeighbors(upTile, mergeUpLeftNeighbors);
+    for(Tile *t : mergeUpLeftNeighbors){
+        if(t->tr == upTile) t->tr = downTile;
     }
 
-    if(t.lb != nullptr){
-        if(!checkVectorInclude(record,t.lb->getLowerLeft())){
-            visualiseDebugDFS(ofs, *(t.lb), record);
-        }
+    std::vector <Tile *> mergeUpRightNeighbors;
+    findRightNeighbors(upTile, mergeUpRightNeighbors);
+    for(Tile *t : mergeUpRightNeighbors){
+        if(t->bl == upTile) t->bl = downTile;
     }
 
-    if(t.bl != nullptr){
-        if(!checkVectorInclude(record,t.bl->getLowerLeft())){
-            visualiseDebugDFS(ofs, *(t.bl), record);
-        }
-    }
+    downTile->rt = upTile->rt;
+    downTile->tr = upTile->tr;
 
-    if(t.tr != nullptr){
-        if(!checkVectorInclude(record,t.tr->getLowerLeft())){
-            visualiseDebugDFS(ofs, *(t.tr), record);
-        }
-    }
-    
-    return;
-}
+    downTile->setHeight(downTile->getHeight() + upTile->getHeight());
 
-void LFLegaliser::detectCombinableBlanks(std::vector <std::pair<Tile *, Tile *>> &candidateTile){
-    
-    std::vector <Cord> record;
+    mTilePool.release(upTile);
 
-    // modified by ryan
-    // original: if(fixedTesserae.size() !=0){
-    if(fixedTesserae.size() !=0 && fixedTesserae[0]->getLegalArea() != 0){
-        if(this->fixedTesserae[0]->TileArr.size() != 0){
-            detectCombinableBlanksDFS(candidateTile, *(this->fixedTesserae[0]->TileArr[0]), record);
-        }else{
-            detectCombinableBlanksDFS(candidateTile, *(this->fixedTesserae[0]->OverlapArr[0]), record);
-        }
-    }else{
-        if(softTesserae.size() != 0){
-            detectCombinableBlanksDFS(candidateTile, *(this->softTesserae[0]->TileArr[0]), record);
-        }else{
-            detectCombinableBlanksDFS(candidateTile, *(this->softTesserae[0]->OverlapArr[0]), record);
-        }
+};
+
+void LFLegaliser::mergeBlankStrips(std::vector<Tile *> &worklist){
+    // a merge releases one of the two tiles, entries are checked against the pool generation before use
+    std::vector <PointHint> pending;
+    pending.reserve(worklist.size());
+    for(Tile *t : worklist){
+        pending.push_back({t, mTilePool.getGeneration(t->getHandle())});
     }
 
-}
+    auto sameSpan = [](Tile *a, Tile *b){
+        return (a->getLowerLeft().x == b->getLowerLeft().x) && (a->getWidth() == b->getWidth());
+    };
 
-void LFLegaliser::detectCombinableBlanksDFS(std::vector <std::pair<Tile *, Tile *>> &candidateTile, Tile &t, std::vector <Cord> &record){
-    
-    record.push_back(t.getLowerLeft());
+    while(!pending.empty()){
+        PointHint cur = pending.back();
+        pending.pop_back();
 
-    // if tile & tile.lb are mergable, push in vector and record!
-    if(t.lb != nullptr){
-        bool typeCorrect = (t.getType() == tileType::BLANK) && (t.lb->getType() == tileType::BLANK);
-        bool leftAligned = (t.getLowerLeft().x == t.lb->getLowerLeft().x);
-        bool rightAligned = (t.getWidth() == t.lb->getWidth());
+        Tile *t = cur.tile;
+        unsigned int handle = t->getHandle();
+        if(!mTilePool.isInUse(handle) || mTilePool.getGeneration(handle) != cur.generation) continue;
+        if(t->getType() != tileType::BLANK) continue;
 
-        if(typeCorrect && leftAligned && rightAligned){
-            candidateTile.push_back(std::make_pair(&t, t.lb));
+        Tile *up = t->rt;
+        if((up != nullptr) && (up->getType() == tileType::BLANK) && sameSpan(t, up)){
+            combineVerticalMergeableBlanks(up, t);
+            pending.push_back({t, mTilePool.getGeneration(handle)});
+            continue;
         }
-    }
-    
 
-    if(t.rt != nullptr){
-        if(!checkVectorInclude(record,t.rt->getLowerLeft())){
-            detectCombinableBlanksDFS(candidateTile, *(t.rt), record);
+        Tile *down = t->lb;
+        if((down != nullptr) && (down->getType() == tileType::BLANK) && sameSpan(t, down)){
+            combineVerticalMergeableBlanks(t, down);
+            pending.push_back({down, mTilePool.getGeneration(down->getHandle())});
         }
     }
+    worklist.clear();
+}
 
-    if(t.lb != nullptr){
-        if(!checkVectorInclude(record,t.lb->getLowerLeft())){
-            detectCombinableBlanksDFS(candidateTile, *(t.lb), record);
-        }
+Tile *LFLegaliser::splitBlankHorizontally(Tile *tile, len_t y){
+    assert(tile->getType() == tileType::BLANK);
+    assert(tile->getLowerLeft().y < y && y < tile->getUpperRight().y);
+    touchPlane();
+
+    len_t xl = tile->getLowerLeft().x;
+    len_t yh = tile->getUpperRight().y;
+    Tile *upper = mTilePool.allocate(tileType::BLANK, Cord(xl, y), tile->getWidth(), yh - y);
+    upper->rt = tile->rt;
+    upper->tr = tile->tr;
+    upper->lb = tile;
+
+    // top neighbors now sit on the upper part
+    for(Tile *t = tile->rt; (t != nullptr) && (t->getLowerLeft().x >= xl); t = t->bl){
+        if(t->lb == tile) t->lb = upper;
     }
 
-    if(t.bl != nullptr){
-        if(!checkVectorInclude(record,t.bl->getLowerLeft())){
-            detectCombinableBlanksDFS(candidateTile, *(t.bl), record);
-        }
+    // left neighbors: the first one reaching above y is the new bl, those ending inside the upper part point at it
+    Tile *left = tile->bl;
+    while((left != nullptr) && (left->getUpperRight().y <= y)) left = left->rt;
+    upper->bl = left;
+    for(; (left != nullptr) && (left->getLowerLeft().y < yh); left = left->rt){
+        if(left->tr == tile) left->tr = upper;
     }
 
-    if(t.tr != nullptr){
-        if(!checkVectorInclude(record,t.tr->getLowerLeft())){
-            detectCombinableBlanksDFS(candidateTile, *(t.tr), record);
-        }
+    // right neighbors starting at or above y belong to the upper part, the first one below is the new tr
+    Tile *right = tile->tr;
+    while((right != nullptr) && (right->getLowerLeft().y >= y)){
+        if(right->bl == tile) right->bl = upper;
+        right = right->lb;
     }
+    tile->tr = right;
+
+    tile->rt = upper;
+    tile->setHeight(y - tile->getLowerLeft().y);
+    return upper;
 }
 
-void LFLegaliser::combineVerticalMergeableBlanks(Tile *upTile, Tile *downTile){
-    std::vector <Tile *> mergeUpUpNeighbors;
-    findTopNeighbors(upTile, mergeUpUpNeighbors);
-    for(Tile *t : mergeUpUpNeighbors){
-        if(t->lb == upTile) t->lb = downTile;
-    }
+void LFLegaliser::mergeBlankHorizontally(Tile *left, Tile *right){
+    assert(left->getType() == tileType::BLANK && right->getType() == tileType::BLANK);
+    assert(left->getUpperRight().x == right->getLowerLeft().x);
+    assert(left->getLowerLeft().y == right->getLowerLeft().y && left->getHeight() == right->getHeight());
+    touchPlane();
 
-    std::vector <Tile *> mergeUpLeftNeighbors;
-    findLeftNeighbors(upTile, mergeUpLeftNeighbors);
-    for(Tile *t : mergeUpLeftNeighbors){
-        if(t->tr == upTile) t->tr = downTile;
-    }
+    len_t xl = right->getLowerLeft().x;
+    len_t xh = right->getUpperRight().x;
+    len_t yl = right->getLowerLeft().y;
 
-    std::vector <Tile *> mergeUpRightNeighbors;
-    findRightNeighbors(upTile, mergeUpRightNeighbors);
-    for(Tile *t : mergeUpRightNeighbors){
-        if(t->bl == upTile) t->bl = downTile;
+    for(Tile *t = right->rt; (t != nullptr) && (t->getLowerLeft().x >= xl); t = t->bl){
+        if(t->lb == right) t->lb = left;
+    }
+    for(Tile *t = right->lb; (t != nullptr) && (t->getLowerLeft().x < xh); t = t->tr){
+        if(t->rt == right) t->rt = left;
+    }
+    for(Tile *t = right->tr; (t != nullptr) && (t->getUpperRight().y > yl); t = t->lb){
+        if(t->bl == right) t->bl = left;
     }
 
-    downTile->rt = upTile->rt;
-    downTile->tr = upTile->tr;
+    left->rt = right->rt;
+    left->tr = right->tr;
+    left->setWidth(left->getWidth() + right->getWidth());
 
-    downTile->setHeight(downTile->getHeight() + upTile->getHeight());
+    mTilePool.release(right);
+}
 
-    delete(upTile);
+void LFLegaliser::deleteTile(Tile *tile){
+    assert(tile != nullptr);
+    assert(tile->getType() != tileType::BLANK);
+    touchPlane();
+    journalEdit(tile->getLowerLeft(), tile->getWidth(), tile->getHeight());
+
+    // detach from every Tessera holding the tile
+    auto detach = [tile](Tessera *tess){
+        std::vector<Tile *>::iterator it = std::find(tess->TileArr.begin(), tess->TileArr.end(), tile);
+        if(it != tess->TileArr.end()) tess->TileArr.erase(it);
+        it = std::find(tess->OverlapArr.begin(), tess->OverlapArr.end(), tile);
+        if(it != tess->OverlapArr.end()) tess->OverlapArr.erase(it);
+    };
+    if(tile->OwnerFixedTesseraIdx >= 0) detach(fixedTesserae[tile->OwnerFixedTesseraIdx]);
+    if(tile->OwnerSoftTesseraIdx >= 0) detach(softTesserae[tile->OwnerSoftTesseraIdx]);
+    for(int idx : tile->OverlapFixedTesseraeIdx) detach(fixedTesserae[idx]);
+    for(int idx : tile->OverlapSoftTesseraeIdx) detach(softTesserae[idx]);
+
+    tile->setType(tileType::BLANK);
+    tile->OwnerFixedTesseraIdx = -1;
+    tile->OwnerSoftTesseraIdx = -1;
+    tile->OverlapFixedTesseraeIdx.clear();
+    tile->OverlapSoftTesseraeIdx.clear();
+
+    len_t yl = tile->getLowerLeft().y;
+    len_t yh = tile->getUpperRight().y;
+    std::vector <Tile *> mergeWorklist;
+    auto isBlank = [](Tile *t){ return (t != nullptr) && (t->getType() == tileType::BLANK); };
+
+    /* STEP 1) Blank neighbors sticking out above or below the freed area are cut at its top / bottom edge */
+    Tile *leftBottom = tile->bl;
+    if(isBlank(leftBottom) && (leftBottom->getLowerLeft().y < yl)){
+        splitBlankHorizontally(leftBottom, yl);
+        mergeWorklist.push_back(leftBottom);
+    }
+    Tile *leftTop = tile->bl;
+    while((leftTop != nullptr) && (leftTop->getUpperRight().y < yh)) leftTop = leftTop->rt;
+    if(isBlank(leftTop) && (leftTop->getUpperRight().y > yh)){
+        mergeWorklist.push_back(splitBlankHorizontally(leftTop, yh));
+    }
+    Tile *rightTop = tile->tr;
+    if(isBlank(rightTop) && (rightTop->getUpperRight().y > yh)){
+        mergeWorklist.push_back(splitBlankHorizontally(rightTop, yh));
+    }
+    Tile *rightBottom = tile->tr;
+    while((rightBottom != nullptr) && (rightBottom->getLowerLeft().y > yl)) rightBottom = rightBottom->lb;
+    if(isBlank(rightBottom) && (rightBottom->getLowerLeft().y < yl)){
+        splitBlankHorizontally(rightBottom, yl);
+        mergeWorklist.push_back(rightBottom);
+    }
+
+    /* STEP 2) Cut the freed area into strips, one per y range where its blank side neighbors are constant */
+    std::vector <len_t> cuts;
+    for(Tile *t = tile->bl; (t != nullptr) && (t->getLowerLeft().y < yh); t = t->rt){
+        if(t->getType() != tileType::BLANK) continue;
+        cuts.push_back(t->getLowerLeft().y);
+        cuts.push_back(t->getUpperRight().y);
+    }
+    for(Tile *t = tile->tr; (t != nullptr) && (t->getUpperRight().y > yl); t = t->lb){
+        if(t->getType() != tileType::BLANK) continue;
+        cuts.push_back(t->getLowerLeft().y);
+        cuts.push_back(t->getUpperRight().y);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    std::vector <Tile *> strips;
+    strips.push_back(tile);
+    for(len_t c : cuts){
+        if(c <= yl || c >= yh) continue;
+        strips.push_back(splitBlankHorizontally(strips.back(), c));
+    }
+
+    /* STEP 3) Bottom to top, join each strip with the blanks on its left and right */
+    for(Tile *strip : strips){
+        len_t stripTop = strip->getUpperRight().y;
+        Tile *merged = strip;
+
+        Tile *left = strip->bl;
+        if(isBlank(left)){
+            if(left->getUpperRight().y > stripTop) splitBlankHorizontally(left, stripTop);
+            mergeBlankHorizontally(left, strip);
+            merged = left;
+        }
+
+        Tile *right = merged->tr;
+        if(isBlank(right)){
+            if(right->getUpperRight().y > stripTop) splitBlankHorizontally(right, stripTop);
+            mergeBlankHorizontally(merged, right);
+        }
+        mergeWorklist.push_back(merged);
+    }
+
+    /* STEP 4) Vertical merges restore the maximal strip form around the freed area */
+    mergeBlankStrips(mergeWorklist);
+}
 
-};
+bool LFLegaliser::checkPlane() const{
+    std::vector <Tile *> allTiles;
+    collectAllTiles(allTiles);
+    auto fail = [](const Tile *t, const char *what){
+        std::cerr << "[LFL] Plane check failed at tile " << *t << ": " << what << std::endl;
+        return false;
+    };
+    auto isBlank = [](const Tile *t){ return (t != nullptr) && (t->getType() == tileType::BLANK); };
+
+    area_t coveredArea = 0;
+    for(Tile *t : allTiles){
+        Cord ll = t->getLowerLeft();
+        Cord ur = t->getUpperRight();
+        coveredArea += t->getArea();
+        if(t->getWidth() <= 0 || t->getHeight() <= 0) return fail(t, "empty tile");
+        if(findPoint(ll) != t) return fail(t, "findPoint misses the lower left corner");
+
+        // each stitch points at the neighbor holding the corner next to it, nullptr at the canvas border
+        if((ur.y == mCanvasHeight) != (t->rt == nullptr)) return fail(t, "rt at canvas border");
+        if(t->rt != nullptr && !(t->rt->getLowerLeft().y == ur.y && t->rt->getLowerLeft().x < ur.x && ur.x <= t->rt->getUpperRight().x)){
+            return fail(t, "rt");
+        }
+        if((ur.x == mCanvasWidth) != (t->tr == nullptr)) return fail(t, "tr at canvas border");
+        if(t->tr != nullptr && !(t->tr->getLowerLeft().x == ur.x && t->tr->getLowerLeft().y < ur.y && ur.y <= t->tr->getUpperRight().y)){
+            return fail(t, "tr");
+        }
+        if((ll.y == 0) != (t->lb == nullptr)) return fail(t, "lb at canvas border");
+        if(t->lb != nullptr && !(t->lb->getUpperRight().y == ll.y && t->lb->getLowerLeft().x <= ll.x && ll.x < t->lb->getUpperRight().x)){
+            return fail(t, "lb");
+        }
+        if((ll.x == 0) != (t->bl == nullptr)) return fail(t, "bl at canvas border");
+        if(t->bl != nullptr && !(t->bl->getUpperRight().x == ll.x && t->bl->getLowerLeft().y <= ll.y && ll.y < t->bl->getUpperRight().y)){
+            return fail(t, "bl");
+        }
+
+        if(!isBlank(t)) continue;
+        for(Tile *n = t->bl; n != nullptr && n->getLowerLeft().y < ur.y; n = n->rt){
+            if(isBlank(n)) return fail(t, "blank on the left");
+        }
+        for(Tile *n = t->tr; n != nullptr && n->getUpperRight().y > ll.y; n = n->lb){
+            if(isBlank(n)) return fail(t, "blank on the right");
+        }
+        if(isBlank(t->lb) && t->lb->getLowerLeft().x == ll.x && t->lb->getWidth() == t->getWidth()){
+            return fail(t, "blank below with the same span");
+        }
+    }
+    if(coveredArea != (area_t) mCanvasWidth * mCanvasHeight){
+        std::cerr << "[LFL] Plane check failed: tiles cover " << coveredArea << " of the canvas area "
+                  << (area_t) mCanvasWidth * mCanvasHeight << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool LFLegaliser::deleteTileSelfTest(unsigned int seed){
+    std::vector <Tile *> solids;
+    collectAllTiles(solids);
+    solids.erase(std::remove_if(solids.begin(), solids.end(), [](Tile *t){ return t->getType() == tileType::BLANK; }), solids.end());
+    std::shuffle(solids.begin(), solids.end(), std::mt19937(seed));
+
+    if(!checkPlane()) return false;
+    // solid tiles are never recycled by deleting another one, the list stays valid
+    for(Tile *tile : solids){
+        deleteTile(tile);
+        if(!checkPlane()) return false;
+    }
+    return true;
+}
 
 bool LFLegaliser::searchTesseraeIncludeTile(Tile *tile, std::vector <Tessera *> &inTessera) const {
     if(tile->getType() == tileType::BLANK) return false;
     bool answer = false;
-    
-    for(Tessera *tess : this->softTesserae){
-        if(tile->getType() == tileType::OVERLAP){
-            for(Tile *t : tess->OverlapArr){
-                if((*tile) == (*t)){
-                    inTessera.push_back(tess);
-                    answer = true;
-                }
-            }
-        }else{ //tileType::block
-            for(Tile *t : tess->TileArr){
-                if((*tile) == (*t)){
-                    inTessera.push_back(tess);
-                    answer = true;
-                }
-            }
-        }
-    }
 
-    for(Tessera *tess : this->fixedTesserae){
-        if(tile->getType() == tileType::OVERLAP){
-            for(Tile *t : tess->OverlapArr){
-                if((*tile) == (*t)){
-                    inTessera.push_back(tess);
-                    answer = true;
-                }
-            }
-        }else{ //tileType::block
-            for(Tile *t : tess->TileArr){
-                if((*tile) == (*t)){
-                    inTessera.push_back(tess);
-                    answer = true;
-                }
-            }
+    // owners are stored on the tile, soft tesserae are reported before fixed ones
+    if(tile->getType() == tileType::OVERLAP){
+        std::vector <int> softIdx(tile->OverlapSoftTesseraeIdx);
+        std::vector <int> fixedIdx(tile->OverlapFixedTesseraeIdx);
+        std::sort(softIdx.begin(), softIdx.end());
+        std::sort(fixedIdx.begin(), fixedIdx.end());
+        for(int idx : softIdx){
+            inTessera.push_back(this->softTesserae[idx]);
+            answer = true;
+        }
+        for(int idx : fixedIdx){
+            inTessera.push_back(this->fixedTesserae[idx]);
+            answer = true;
+        }
+    }else{ //tileType::block
+        if(tile->OwnerSoftTesseraIdx >= 0){
+            inTessera.push_back(this->softTesserae[tile->OwnerSoftTesseraIdx]);
+            answer = true;
+        }
+        if(tile->OwnerFixedTesseraIdx >= 0){
+            inTessera.push_back(this->fixedTesserae[tile->OwnerFixedTesseraIdx]);
+            answer = true;
         }
     }
     assert(answer);
@@ -1932,41 +2068,58 @@ void LFLegaliser::collectAllTiles(std::vector<Tile *> &allTiles) const{
     if(fixedTesserae.empty() && softTesserae.empty()) return;
 
     Tile *seed = getRandomTile();
-    std::vector <Cord> record; // This records which Tile has been visited;
-    
-    collectAllTilesDFS((*seed), record, allTiles);
+    enumerateAllTiles(seed, [&allTiles](Tile *t){ allTiles.push_back(t); });
 }
 
-void LFLegaliser::collectAllTilesDFS(Tile &head, std::vector <Cord> &record, std::vector<Tile *> &allTiles) const{
-    record.push_back(head.getLowerLeft());
-    allTiles.push_back(&head);
+unsigned long long LFLegaliser::nextVisitEpoch() const{
+    return ++mVisitEpoch;
+}
 
-    if(head.rt != nullptr){
-        if(!checkVectorInclude(record, head.rt->getLowerLeft())){
-            collectAllTilesDFS((*(head.rt)), record, allTiles);
-        }
-    }
-    if(head.lb != nullptr){
-        if(!checkVectorInclude(record, head.lb->getLowerLeft())){
-            collectAllTilesDFS((*(head.lb)), record, allTiles);
+void LFLegaliser::enumerateAllTiles(Tile *seed, const std::function<void(Tile *)> &visit) const{
+    if(seed == nullptr) return;
+
+    const unsigned long long epoch = nextVisitEpoch();
+
+    // explicit stack replacing the recursion, "dir" is the next stitch to try: 0 = rt, 1 = lb, 2 = bl, 3 = tr
+    struct Frame {
+        Tile *tile;
+        int dir;
+    };
+    std::vector<Frame> stack;
+    stack.reserve(64);
+
+    seed->visitStamp = epoch;
+    visit(seed);
+    stack.push_back({seed, 0});
+
+    while(!stack.empty()){
+        Frame &top = stack.back();
+        if(top.dir == 4){
+            stack.pop_back();
+            continue;
         }
-    }
-    if(head.bl != nullptr){
-        if(!checkVectorInclude(record, head.bl->getLowerLeft())){
-            collectAllTilesDFS((*(head.bl)), record, allTiles);
+
+        Tile *next;
+        switch(top.dir++){
+            case 0: next = top.tile->rt; break;
+            case 1: next = top.tile->lb; break;
+            case 2: next = top.tile->bl; break;
+            default: next = top.tile->tr; break;
         }
-    }
-    if(head.tr != nullptr){
-        if(!checkVectorInclude(record, head.tr->getLowerLeft())){
-            collectAllTilesDFS((*(head.tr)), record, allTiles);
+
+        if(next != nullptr && next->visitStamp != epoch){
+            next->visitStamp = epoch;
+            visit(next);
+            stack.push_back({next, 0});
         }
     }
 }
 
 // added by ryan
 Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
-    // find original Tessera(s) that tile belongs to 
-    // SHOULD BE IMPROVED
+    touchPlane();
+    journalEdit(originalTile->getLowerLeft(), originalTile->getWidth(), originalTile->getHeight());
+    // find original Tessera(s) that tile belongs to, read straight from the tile
     int fixedTessNum = fixedTesserae.size();
     std::vector<int> belongTessIndexes;
     if (originalTile->OverlapFixedTesseraeIdx.size() + originalTile->OverlapSoftTesseraeIdx.size() > 0){
@@ -1977,30 +2130,11 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
             belongTessIndexes.push_back(overlapIndex + fixedTessNum);
         }
     }
-    else {
-        bool found = false;
-        for (int i = 0; i < fixedTesserae.size(); i++){
-            Tessera* tess = fixedTesserae[i];
-            for (Tile* tessTile: tess->TileArr){
-                if (tessTile == originalTile){
-                    belongTessIndexes.push_back(i);
-                    found = true;
-                    break;
-                }
-            }
-        }
-        if (!found){
-            for (int i = 0; i < softTesserae.size(); i++){
-                Tessera* tess = softTesserae[i];
-                for (Tile* tessTile: tess->TileArr){
-                    if (tessTile == originalTile){
-                        belongTessIndexes.push_back(i + fixedTessNum);
-                        found = true;
-                        break;
-                    }
-                }
-            }
-        }
+    else if (originalTile->OwnerFixedTesseraIdx >= 0){
+        belongTessIndexes.push_back(originalTile->OwnerFixedTesseraIdx);
+    }
+    else if (originalTile->OwnerSoftTesseraIdx >= 0){
+        belongTessIndexes.push_back(originalTile->OwnerSoftTesseraIdx + fixedTessNum);
     }
     
     Rectangle originalRect(originalTile->getLowerLeft().x, originalTile->getLowerLeft().y, 
@@ -2020,7 +2154,7 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
     // split top if necessary
     if (gtl::yh(newRect) < gtl::yh(originalRect)){
         // create new tile to represent the top
-        Tile* newTopTile = new Tile(*(originalTile));
+        Tile* newTopTile = mTilePool.allocate(*(originalTile));
         newTopTile->setHeight(gtl::yh(originalRect) - gtl::yh(newRect));
         newTopTile->setCord(Cord(gtl::xl(originalRect), gtl::yh(newRect)));
 
@@ -2056,28 +2190,28 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
         // adjust the ptrs of left, top, right neighbors
         // left
         for (Tile* leftNeighbor: leftNeighbors){
-            int neighborYh = leftNeighbor->getUpperRight().y;
+            len_t neighborYh = leftNeighbor->getUpperRight().y;
             if (newTopTile->getLowerLeft().y < neighborYh && neighborYh <= newTopTile->getUpperRight().y){
                 leftNeighbor->tr = newTopTile;
             }
         }
         // top
         for (Tile* topNeighbor: topNeighbors){
-            int neighborXl = topNeighbor->getLowerLeft().x;
+            len_t neighborXl = topNeighbor->getLowerLeft().x;
             if (newTopTile->getLowerLeft().x <= neighborXl && neighborXl < newTopTile->getUpperRight().x){
                 topNeighbor->lb = newTopTile;
             }
         }
         // right
         for (Tile* rightNeighbor: rightNeighbors){
-            int neighborYl = rightNeighbor->getLowerLeft().y;
+            len_t neighborYl = rightNeighbor->getLowerLeft().y;
             if (newTopTile->getLowerLeft().y <= neighborYl && neighborYl < newTopTile->getUpperRight().y){
                 rightNeighbor->bl = newTopTile;
             }
         }
 
         // adjust x, y, width, height of old tile
-        int newHeight = originalTile->getHeight() - newTopTile->getHeight();
+        len_t newHeight = originalTile->getHeight() - newTopTile->getHeight();
         originalTile->setHeight(newHeight);
 
         // add newTile to tessera(s)
@@ -2099,7 +2233,7 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
     // split bottom if necessary
     if (gtl::yl(newRect) > gtl::yl(originalRect)){
         // create new tile to represent the bottom
-        Tile* newBottomTile = new Tile(*(originalTile));
+        Tile* newBottomTile = mTilePool.allocate(*(originalTile));
         newBottomTile->setHeight(gtl::yl(newRect) - gtl::yl(originalRect));
 
         // find new tr, bl pointers
@@ -2134,28 +2268,28 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
         // adjust the ptrs of left, bottom, right neighbors
         // left
         for (Tile* leftNeighbor: leftNeighbors){
-            int neighborYh = leftNeighbor->getUpperRight().y;
+            len_t neighborYh = leftNeighbor->getUpperRight().y;
             if (newBottomTile->getLowerLeft().y < neighborYh && neighborYh <= newBottomTile->getUpperRight().y){
                 leftNeighbor->tr = newBottomTile;
             }
         }
         // bottom
         for (Tile* bottomNeighbor: bottomNeighbors){
-            int neighborXh = bottomNeighbor->getUpperRight().x;
+            len_t neighborXh = bottomNeighbor->getUpperRight().x;
             if (newBottomTile->getLowerLeft().x < neighborXh && neighborXh <= newBottomTile->getUpperRight().x){
                 bottomNeighbor->rt = newBottomTile;
             }
         }
         // right
         for (Tile* rightNeighbor: rightNeighbors){
-            int neighborYl = rightNeighbor->getLowerLeft().y;
+            len_t neighborYl = rightNeighbor->getLowerLeft().y;
             if (newBottomTile->getLowerLeft().y <= neighborYl && neighborYl < newBottomTile->getUpperRight().y){
                 rightNeighbor->bl = newBottomTile;
             }
         }
 
         // adjust x, y, width, height of old tile
-        int newHeight = originalTile->getHeight() - newBottomTile->getHeight();
+        len_t newHeight = originalTile->getHeight() - newBottomTile->getHeight();
         originalTile->setHeight(newHeight);
         originalTile->setCord(Cord(gtl::xl(originalRect), gtl::yl(newRect)));
 
@@ -2178,7 +2312,7 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
     // split right if necessary
     if (gtl::xh(newRect) < gtl::xh(originalRect)){
         // create new tile to represent the right
-        Tile* newRightTile = new Tile(*(originalTile));
+        Tile* newRightTile = mTilePool.allocate(*(originalTile));
         newRightTile->setWidth(gtl::xh(originalRect) - gtl::xh(newRect));
         newRightTile->setCord(Cord(gtl::xh(newRect), gtl::yl(newRect)));
 
@@ -2214,28 +2348,28 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
         // adjust the ptrs of top, right, bottom neighbors
         // top
         for (Tile* topNeighbor: topNeighbors){
-            int neighborXl = topNeighbor->getLowerLeft().x;
+            len_t neighborXl = topNeighbor->getLowerLeft().x;
             if (newRightTile->getLowerLeft().x <= neighborXl && neighborXl < newRightTile->getUpperRight().x){
                 topNeighbor->lb = newRightTile;
             }
         }
         // right
         for (Tile* rightNeighbor: rightNeighbors){
-            int neighborYl = rightNeighbor->getLowerLeft().y;
+            len_t neighborYl = rightNeighbor->getLowerLeft().y;
             if (newRightTile->getLowerLeft().y <= neighborYl && neighborYl < newRightTile->getUpperRight().y){
                 rightNeighbor->bl = newRightTile;
             }
         }
         // bottom
         for (Tile* bottomNeighbor: bottomNeighbors){
-            int neighborXh = bottomNeighbor->getUpperRight().x;
+            len_t neighborXh = bottomNeighbor->getUpperRight().x;
             if (newRightTile->getLowerLeft().x < neighborXh && neighborXh <= newRightTile->getUpperRight().x){
                 bottomNeighbor->rt = newRightTile;
             }
         }
 
         // adjust x,y,width,height of old tile;
-        int newWidth = originalTile->getWidth() - newRightTile->getWidth();
+        len_t newWidth = originalTile->getWidth() - newRightTile->getWidth();
         originalTile->setWidth(newWidth);
 
         // add newTile to tessera(s)
@@ -2253,7 +2387,7 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
     // split left if necessary
     if (gtl::xl(originalRect) < gtl::xl(newRect)){
         // create new tile to represent the left
-        Tile* newLeftTile = new Tile(*(originalTile));
+        Tile* newLeftTile = mTilePool.allocate(*(originalTile));
         newLeftTile->setWidth(gtl::xl(newRect) - gtl::xl(originalRect));
 
         // find new rt, lb pointers
@@ -2288,28 +2422,28 @@ Tile* LFLegaliser::splitTile(Tile* originalTile, Rectangle newRect){
         // adjust the ptrs of bottom, left, top neighbors
         // bottom
         for (Tile* bottomNeighbor: bottomNeighbors){
-            int neighborXh = bottomNeighbor->getUpperRight().x;
+            len_t neighborXh = bottomNeighbor->getUpperRight().x;
             if (newLeftTile->getLowerLeft().x < neighborXh && neighborXh <= newLeftTile->getUpperRight().x){
                 bottomNeighbor->rt = newLeftTile;
             }
         }
         // left
         for (Tile* leftNeighbor: leftNeighbors){
-            int neighborYh = leftNeighbor->getUpperRight().y;
+            len_t neighborYh = leftNeighbor->getUpperRight().y;
             if (newLeftTile->getLowerLeft().y < neighborYh && neighborYh <= newLeftTile->getUpperRight().y){
                 leftNeighbor->tr = newLeftTile;
             }
         }
         // top
         for (Tile* topNeighbor: topNeighbors){
-            int neighborXl = topNeighbor->getLowerLeft().x;
+            len_t neighborXl = topNeighbor->getLowerLeft().x;
             if (newLeftTile->getLowerLeft().x <= neighborXl && neighborXl < newLeftTile->getUpperRight().x){
                 topNeighbor->lb = newLeftTile;
             }
         }
 
         // adjust x,y,width,height of old tile;
-        int newWidth = originalTile->getWidth() - newLeftTile->getWidth();
+        len_t newWidth = originalTile->getWidth() - newLeftTile->getWidth();
         Cord newLL = newLeftTile->getLowerRight();
         originalTile->setWidth(newWidth);
         originalTile->setLowerLeft(newLL);
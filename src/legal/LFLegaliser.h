@@ -7,15 +7,33 @@
 #include <cmath>
 #include <algorithm>
 #include <utility>
+#include <functional>
 #include "LFUnits.h"
 #include "Tile.h"
 #include "Tessera.h"
+#include "TilePool.h"
+#include "TilePlane.h"
 
 // namespace pp = PushPull;
 // namespace rg = RectGrad;
 
 struct Connection;
 
+// entry tile for point location, valid while the pool generation of the tile is unchanged
+struct PointHint{
+    Tile *tile;
+    unsigned int generation;
+};
+
+// Saved state of a whole LFLegaliser (plane, tesserae and marks), see LFLegaliser::takeSnapshot
+struct PlaneSnapshot{
+    TilePoolSnapshot pool;
+    std::vector <Tessera> fixedTesserae;
+    std::vector <Tessera> softTesserae;
+    std::vector <Tile *> markedTiles;
+    bool overlap3;
+};
+
 class LFLegaliser {
 private:
     len_t mCanvasWidth;
@@ -23,22 +41,64 @@ private:
 
     bool overlap3;
 
+    // owns every Tile of the plane and of the tesserae
+    TilePool mTilePool;
+
+    // Optional SoA mirror of the plane. Bumped on every edit, findPoint and the neighbor walks are served by
+    // mTilePlane only while it was built for the current mPlaneVersion, otherwise they walk the Tiles themselves
+    unsigned long long mPlaneVersion;
+    TilePlane mTilePlane;
+    void touchPlane();
+    bool tilePlaneActive() const;
+
+    // Point location acceleration: the canvas is cut into a coarse uniform grid, each cell remembers a tile that
+    // was recently located inside it. findPoint starts walking from the hint of the cell holding the key.
+    // Hints are validated against the pool generation, so recycled tiles are never used as a starting point.
+    static const int POINT_HINT_GRID_DIM = 32;
+    mutable std::vector <PointHint> mPointHints;
+    mutable len_t mHintCellWidth, mHintCellHeight;
+    mutable Tile *mLastHitTile;
+    mutable unsigned int mLastHitGeneration;
+
+    Tile *getPointHint(const Cord &key) const;
+    void setPointHint(const Cord &key, Tile *tile) const;
+
+    // splitTesseraeOverlaps computes the strips of the Tesserae on separate threads once this many need a split
+    static const int SPLIT_THREAD_THRESHOLD = 64;
     bool checkTesseraInCanvas(Cord lowerLeft, len_t width, len_t height) const;
     bool checkTileInCanvas(Tile &tile) const;
 
-    void traverseBlank(std::ofstream &ofs, Tile &t, std::vector <Cord> &record);
-    // void visualiseResetDFS(Tile &t, std::vector <Cord> &record);
-    void visualiseDebugDFS(std::ofstream &ofs, Tile &t, std::vector <Cord> &record);
+    // epoch of the latest plane walk, compared against Tile::visitStamp
+    mutable unsigned long long mVisitEpoch;
+    unsigned long long nextVisitEpoch() const;
+
+    // scratch stack of enumerateDirectArea, kept to avoid allocating on every query
+    mutable std::vector <Tile *> mAreaQueryStack;
+    // set while enumerateDirectArea runs, the scratch stack allows no nested query
+    mutable bool mAreaQueryActive;
+
 
+    // next tile down the vertical line x, below "current", nullptr at the bottom of the canvas
+    Tile *nextLeftEdgeTile(Tile *current, len_t x) const;
 
-    // subRoutine used in enumerateDirectArea
-    void enumerateDirectAreaRProcess(Cord lowerleft, len_t width, len_t height, std::vector <Tile *> &allTiles, Tile *targetTile) const;
+    // points the tile arrays of a Tessera copied from another LFLegaliser at the clones in mTilePool
+    void remapTesseraTiles(Tessera *tess);
+
+    // Cuts BLANK "tile" along the horizontal line y, "tile" keeps the lower part and the upper part is returned
+    Tile *splitBlankHorizontally(Tile *tile, len_t y);
+    // Absorbs BLANK "right" into its left neighbor "left", both must span the same y range
+    void mergeBlankHorizontally(Tile *left, Tile *right);
+
+    // Edit journal, see setEditJournal
+    bool mEditJournalOn;
+    std::vector <Rectangle> mEditedAreas;
+    std::vector <Tile *> mEditedTiles;
+    // Records the area [lowerLeft, width x height] and every tile touching it, must be called before the edit
+    void journalEdit(Cord lowerLeft, len_t width, len_t height);
 
     // This is for marking tiles to show on presentation
     std::vector <Tile *> mMarkedTiles;
 
-    void detectCombinableBlanksDFS(std::vector <std::pair<Tile *, Tile *>> &candidateTile, Tile &t, std::vector <Cord> &record);
-    void collectAllTilesDFS(Tile &head, std::vector <Cord> &record, std::vector<Tile *> &allTiles) const;
 
 public:
     std::vector <Tessera *> fixedTesserae;
@@ -52,6 +112,12 @@ public:
 
     // LFLegaliser& operator = (const LFLegaliser &other);
 
+    // Saves the current plane in O(n). Restoring brings back the exact same Tile and Tessera pointers, so a snapshot
+    // can only be restored into the LFLegaliser it was taken from. Anything caching tiles (eg. the DFSL graph)
+    // must be rebuilt after a restore.
+    void takeSnapshot(PlaneSnapshot &snap) const;
+    void restoreSnapshot(const PlaneSnapshot &snap);
+
     len_t getCanvasWidth() const;
     len_t getCanvasHeight() const;
 
@@ -65,14 +131,43 @@ public:
 
     void arrangeTesseraetoCanvas();
 
+    // Any tile of the plane, every full plane walk starts from it. Falls back to other tiles once deleteTile emptied
+    // the usual Tessera
     Tile *getRandomTile() const;
 
+    // Tiles must be created and recycled through these, never by new/delete
+    Tile *allocateTile(tileType t, Cord LL, len_t w, len_t h);
+    Tile *allocateTile(const Tile &other);
+    void releaseTile(Tile *tile);
+    TilePool &getTilePool();
+
+    // (Re)builds the SoA mirror for the current plane, queries run on it until the next plane edit
+    void syncTilePlane();
+    // Drops the mirror, queries go back to walking the Tiles
+    void dropTilePlane();
+    // The mirror, only meaningful right after syncTilePlane() and before any edit
+    const TilePlane &getTilePlane() const;
+
+    // Edit journal: while enabled, insertTile, splitTile and deleteTile record the area they change together with
+    // every tile touching that area before the edit. Every tile created, removed or reshaped by an edit touches its
+    // area, so caches built over the plane (eg. the DFSL graph) only need to refresh around the journaled areas.
+    // Recorded tiles may have been recycled by later edits, compare them by handle only
+    void setEditJournal(bool enable);
+    bool isEditJournalOn() const;
+    void clearEditJournal();
+    const std::vector<Rectangle> &getEditedAreas() const;
+    const std::vector<Tile *> &getEditedTiles() const;
+    // Every tile touching one of the journaled areas now, each listed once
+    void collectEditedNeighbourhood(std::vector<Tile *> &tiles) const;
+
 
     /* Functions proposed in the paper */
 
     // Returns the Tile that includes the Cord "key"
     Tile *findPoint(const Cord &key) const;
     Tile *findPoint(const Cord &key, Tile *initTile) const;
+    // Drops every point location hint, must be called if the plane is rebuilt without going through the pool
+    void resetPointHints();
 
     // Pushes all neighbors of Tile "centre" to vector "neighbors"
     void findTopNeighbors(Tile *centre, std::vector<Tile *> &neighbors) const;
@@ -86,25 +181,50 @@ public:
     // Clone of searchArea, no "target" is returned
     bool searchArea(Cord lowerleft, len_t width, len_t height) const;
 
-    // Enumerates all tiles in a given area, each tile is visited only after all the tiles above and to its left does
+    // Enumerates all solid tiles in a given area, each tile is visited only after all the tiles above and to its left does
     void enumerateDirectArea(Cord lowerleft, len_t width, len_t height, std::vector <Tile *> &allTiles) const;
+    // Same order, every tile (blank included) intersecting the area is passed to "visit", returning false stops the query.
+    // Returns false if stopped early. Iterative and allocation free once the scratch stack has grown. Single threaded and
+    // not reentrant: the scratch stack and the point hints of findPoint are shared, "visit" must neither modify the
+    // plane nor start another area query
+    bool enumerateDirectArea(Cord lowerleft, len_t width, len_t height, const std::function<bool(Tile *)> &visit) const;
     
 
     void insertFirstTile(Tile &newtile);
     void insertTile(Tile &tile);
+    // Removes "tile" from the plane (and from the Tesserae holding it), its area becomes blank again.
+    // Neighbors are restitched and the freed area is merged with the surrounding blanks back into maximal strip form,
+    // cost is proportional to the neighbors of "tile"
+    void deleteTile(Tile *tile);
+    // Full plane consistency check: every stitch points at the right neighbor, findPoint finds every tile, the tiles
+    // cover the canvas exactly and blanks are maximal horizontal strips, merged vertically when their spans match.
+    // Reports the first violation on stderr
+    bool checkPlane() const;
+    // Deletes every solid tile in a shuffled order ("seed"), checking the plane after each deletion.
+    // Leaves the plane empty, returns false at the first failed check
+    bool deleteTileSelfTest(unsigned int seed);
+    // Builds the whole plane from scratch in one bottom-up sweep, the canvas must be empty.
+    // Blank tiles come out as maximal horizontal strips, merged vertically when their spans match.
+    void buildPlane(const std::vector<Tile *> &solids);
     
     Tile* splitTile(Tile* tile, Rectangle rect);
 
     void visualiseAddMark(Tile *markTile);
     void visualiseRemoveAllmark();
 
-    void detectCombinableBlanks(std::vector <std::pair<Tile *, Tile *>> &candidateTile);
     void combineVerticalMergeableBlanks(Tile *upTile, Tile *downTile);
+    // Merges every blank in "worklist" with the blank above / below it as long as their x-spans match,
+    // restoring the maximal horizontal strip form around a local edit. Only touches the neighbourhood of the worklist
+    void mergeBlankStrips(std::vector<Tile *> &worklist);
 
     bool searchTesseraeIncludeTile(Tile *tile, std::vector <Tessera *> &inTessera) const;
 
     void collectAllTiles(std::vector<Tile *> &allTiles) const;
 
+    // Visits every tile reachable from "seed" exactly once, in the same preorder as a recursive rt, lb, bl, tr DFS
+    // Iterative and O(n), "visit" must not modify the stitches of the plane
+    void enumerateAllTiles(Tile *seed, const std::function<void(Tile *)> &visit) const;
+
     double calculateHPWL();
 
     // io related
@@ -125,11 +245,6 @@ int findVectorIncludebyName(std::vector<Tessera *>&vec, Tessera *tess);
 // void outputFinalAnswer(LFLegaliser *legaliser, const rg::Parser &rgparser, const std::string outputFileName);
 
 
-struct CPTilePair{
-    Tile *father;
-    Tile *baby;
-};
-
 struct Connection{
     std::vector<std::string> modules;
     double value;
@@ -3,8 +3,14 @@
 
 #include <iostream>
 
+// Coordinate precision is picked at build time: 32-bit by default, 64-bit with -DLF_COORD64 (make COORD64=1).
+// Areas are always 64-bit so the product of two coordinates never overflows.
+#ifdef LF_COORD64
+typedef long long len_t;
+#else
 typedef int len_t;
-typedef int area_t;
+#endif
+typedef long long area_t;
 
 class Cord{
 public:
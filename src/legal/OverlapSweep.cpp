@@ -0,0 +1,212 @@
+#include <assert.h>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <thread>
+#include "OverlapSweep.h"
+
+OverlapSweep::OverlapSweep(unsigned int threadThreshold, unsigned int threadNum)
+    : mThreadThreshold(threadThreshold), mThreadNum(threadNum) {}
+
+int OverlapSweep::insert(Cord lowerLeft, len_t width, len_t height){
+    assert(width >= 0 && height >= 0);
+    mRects.push_back({lowerLeft.x, lowerLeft.y, lowerLeft.x + width, lowerLeft.y + height});
+    return mRects.size() - 1;
+}
+
+int OverlapSweep::size() const{
+    return mRects.size();
+}
+
+void OverlapSweep::sweepBand(len_t bandLow, len_t bandHigh, int minDepth, std::vector<OverlapRect> &regions) const{
+    // rectangles clipped to the band, entering at their bottom edge and leaving at their top edge
+    std::vector <std::pair<len_t, int>> starts, ends;
+    for(int i = 0; i < mRects.size(); ++i){
+        const Rect &r = mRects[i];
+        len_t yl = std::max(r.yl, bandLow);
+        len_t yh = std::min(r.yh, bandHigh);
+        if(yl >= yh || r.xl >= r.xh) continue;
+        starts.push_back(std::make_pair(yl, i));
+        ends.push_back(std::make_pair(yh, i));
+    }
+    std::sort(starts.begin(), starts.end());
+    std::sort(ends.begin(), ends.end());
+
+    struct Strip{
+        len_t xl, xh, yl;
+        std::vector <int> owners;
+    };
+    typedef std::map<len_t, std::vector<int>> Cover;
+
+    // the owner set of the active rectangles on [x, next x) is stored at x, left of the first x it is empty.
+    // Neighboring intervals always differ, so every interval is a maximal one
+    Cover cover;
+    // strips still growing upwards, by left x. Each one matches an interval of cover with at least minDepth owners
+    std::map <len_t, Strip> open;
+    std::vector <std::pair<len_t, len_t>> dirty;
+    const std::vector <int> noOwners;
+
+    auto closeStrip = [&regions](const Strip &s, len_t yh){
+        regions.push_back({Cord(s.xl, s.yl), s.xh - s.xl, yh - s.yl, s.owners});
+    };
+    auto ownersLeftOf = [&](Cover::iterator it) -> const std::vector<int>& {
+        return (it == cover.begin()) ? noOwners : std::prev(it)->second;
+    };
+    // makes x the start of an interval
+    auto split = [&](len_t x){
+        Cover::iterator it = cover.lower_bound(x);
+        if(it != cover.end() && it->first == x) return it;
+        return cover.emplace_hint(it, x, ownersLeftOf(it));
+    };
+    // drops x as an interval start if nothing changes there
+    auto merge = [&](Cover::iterator it){
+        if(it->second == ownersLeftOf(it)) cover.erase(it);
+    };
+
+    int si = 0, ei = 0;
+    while(si < starts.size() || ei < ends.size()){
+        len_t y;
+        if(si == starts.size()) y = ends[ei].first;
+        else if(ei == ends.size()) y = starts[si].first;
+        else y = std::min(starts[si].first, ends[ei].first);
+
+        // only the x intervals under the rectangles entering or leaving at y change
+        dirty.clear();
+        for(; ei < ends.size() && ends[ei].first == y; ++ei){
+            int id = ends[ei].second;
+            const Rect &r = mRects[id];
+            Cover::iterator low = cover.find(r.xl), high = cover.find(r.xh);
+            assert(low != cover.end() && high != cover.end());
+            for(Cover::iterator it = low; it != high; ++it){
+                std::vector<int>::iterator pos = std::lower_bound(it->second.begin(), it->second.end(), id);
+                assert(pos != it->second.end() && *pos == id);
+                it->second.erase(pos);
+            }
+            merge(high);
+            merge(low);
+            dirty.push_back(std::make_pair(r.xl, r.xh));
+        }
+        for(; si < starts.size() && starts[si].first == y; ++si){
+            int id = starts[si].second;
+            const Rect &r = mRects[id];
+            Cover::iterator low = split(r.xl), high = split(r.xh);
+            for(Cover::iterator it = low; it != high; ++it){
+                it->second.insert(std::upper_bound(it->second.begin(), it->second.end(), id), id);
+            }
+            dirty.push_back(std::make_pair(r.xl, r.xh));
+        }
+        std::sort(dirty.begin(), dirty.end());
+        int dirtyNum = 0;
+        for(const std::pair<len_t, len_t> &range : dirty){
+            if(dirtyNum != 0 && range.first <= dirty[dirtyNum - 1].second){
+                dirty[dirtyNum - 1].second = std::max(dirty[dirtyNum - 1].second, range.second);
+            }else{
+                dirty[dirtyNum++] = range;
+            }
+        }
+        dirty.resize(dirtyNum);
+
+        // strips touching a changed range are closed at y unless their interval survived unchanged
+        for(const std::pair<len_t, len_t> &range : dirty){
+            std::map<len_t, Strip>::iterator it = open.lower_bound(range.first);
+            if(it != open.begin() && std::prev(it)->second.xh >= range.first) --it;
+            while(it != open.end() && it->first <= range.second){
+                const Strip &s = it->second;
+                Cover::iterator interval = cover.find(s.xl);
+                if(interval != cover.end() && std::next(interval) != cover.end()
+                    && std::next(interval)->first == s.xh && interval->second == s.owners){
+                    ++it;
+                }else{
+                    closeStrip(s, y);
+                    it = open.erase(it);
+                }
+            }
+        }
+        // and deep enough intervals there without a strip open a new one
+        for(const std::pair<len_t, len_t> &range : dirty){
+            Cover::iterator it = cover.lower_bound(range.first);
+            if(it != cover.begin()) --it;
+            for(; it != cover.end() && it->first <= range.second; ++it){
+                Cover::iterator next = std::next(it);
+                if(next == cover.end() || it->second.size() < minDepth || open.count(it->first)) continue;
+                open.emplace(it->first, Strip{it->first, next->first, y, it->second});
+            }
+        }
+    }
+    assert(open.empty() && cover.empty());
+}
+
+void OverlapSweep::extract(std::vector<OverlapRect> &regions, int minDepth) const{
+    assert(minDepth >= 1);
+    regions.clear();
+    if(mRects.empty()) return;
+
+    std::vector <len_t> ys;
+    ys.reserve(mRects.size() * 2);
+    for(const Rect &r : mRects){
+        ys.push_back(r.yl);
+        ys.push_back(r.yh);
+    }
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    // band boundaries are picked among the edge coordinates so every band sees about the same number of events
+    unsigned int bandNum = 1;
+    if(mThreadThreshold != 0 && mRects.size() >= mThreadThreshold){
+        bandNum = (mThreadNum != 0) ? mThreadNum : std::max(1u, std::thread::hardware_concurrency());
+        bandNum = std::min<unsigned int>(bandNum, ys.size() - 1);
+    }
+    std::vector <len_t> bounds;
+    for(unsigned int b = 0; b < bandNum; ++b){
+        len_t y = ys[(ys.size() - 1) * b / bandNum];
+        if(bounds.empty() || bounds.back() != y) bounds.push_back(y);
+    }
+    bounds.push_back(ys.back());
+
+    if(bounds.size() <= 2){
+        sweepBand(bounds.front(), bounds.back(), minDepth, regions);
+    }else{
+        std::vector <std::vector<OverlapRect>> bandRegions(bounds.size() - 1);
+        std::vector <std::thread> workers;
+        for(int b = 0; b < bandRegions.size(); ++b){
+            workers.push_back(std::thread([this, b, minDepth, &bounds, &bandRegions](){
+                sweepBand(bounds[b], bounds[b + 1], minDepth, bandRegions[b]);
+            }));
+        }
+        for(std::thread &t : workers){
+            t.join();
+        }
+
+        // strips cut by a band boundary are joined with their continuation in the band above
+        regions.swap(bandRegions[0]);
+        for(int b = 1; b < bandRegions.size(); ++b){
+            len_t boundary = bounds[b];
+            std::map <len_t, int> endingAt;
+            for(int i = 0; i < regions.size(); ++i){
+                if(regions[i].lowerLeft.y + regions[i].height == boundary){
+                    endingAt[regions[i].lowerLeft.x] = i;
+                }
+            }
+            for(OverlapRect &r : bandRegions[b]){
+                if(r.lowerLeft.y == boundary){
+                    std::map<len_t, int>::iterator it = endingAt.find(r.lowerLeft.x);
+                    if(it != endingAt.end()){
+                        OverlapRect &below = regions[it->second];
+                        if(below.width == r.width && below.owners == r.owners){
+                            below.height += r.height;
+                            continue;
+                        }
+                    }
+                }
+                regions.push_back(r);
+            }
+        }
+    }
+
+    std::sort(regions.begin(), regions.end(), [](const OverlapRect &a, const OverlapRect &b){
+        if(a.owners.size() != b.owners.size()) return a.owners.size() > b.owners.size();
+        if(a.owners != b.owners) return a.owners < b.owners;
+        if(a.lowerLeft.y != b.lowerLeft.y) return a.lowerLeft.y < b.lowerLeft.y;
+        return a.lowerLeft.x < b.lowerLeft.x;
+    });
+}
@@ -0,0 +1,47 @@
+#ifndef __OVERLAPSWEEP_H__
+#define __OVERLAPSWEEP_H__
+
+#include <vector>
+#include "LFUnits.h"
+
+// A rectangle covered by at least "minDepth" input rectangles, "owners" lists the ids of all of them in ascending order
+struct OverlapRect{
+    Cord lowerLeft;
+    len_t width;
+    len_t height;
+    std::vector <int> owners;
+};
+
+// Scanline extraction of every overlap region of a set of axis aligned rectangles, at any depth.
+// A horizontal line sweeps bottom-up over the rectangle edges and keeps the maximal x intervals of constant owner set in
+// an ordered map, only the intervals under the rectangles entering or leaving at an edge are updated and reclassified,
+// the strips over all other intervals just keep growing. Every region comes
+// out in maximal horizontal strips: a strip never has a neighbor with the same owner set on its left or right, and
+// never one with the same owner set and x span directly above or below.
+// With many rectangles the canvas is cut into horizontal bands swept by separate threads, strips crossing a band
+// boundary are stitched back together afterwards, so the result does not depend on the thread count.
+class OverlapSweep{
+private:
+    struct Rect{
+        len_t xl, yl, xh, yh;
+    };
+    std::vector <Rect> mRects;
+    unsigned int mThreadThreshold;
+    unsigned int mThreadNum;
+
+    void sweepBand(len_t bandLow, len_t bandHigh, int minDepth, std::vector<OverlapRect> &regions) const;
+
+public:
+    // "threadThreshold": minimum rectangle count before the sweep is split into bands, 0 keeps it single threaded
+    // "threadNum": number of bands (and threads) past the threshold, 0 uses one per hardware thread
+    OverlapSweep(unsigned int threadThreshold = 1024, unsigned int threadNum = 0);
+
+    // returns the id of the rectangle, ids are handed out from 0 in insertion order
+    int insert(Cord lowerLeft, len_t width, len_t height);
+    int size() const;
+
+    // Every region covered by at least "minDepth" rectangles, ordered by depth (deepest first), then owner set, y and x
+    void extract(std::vector<OverlapRect> &regions, int minDepth = 2) const;
+};
+
+#endif // __OVERLAPSWEEP_H__
@@ -0,0 +1,136 @@
+#include <assert.h>
+#include <algorithm>
+#include "RectilinearBoolean.h"
+
+RectilinearBoolean::RectilinearBoolean() {}
+
+void RectilinearBoolean::insert(int operand, Cord lowerLeft, len_t width, len_t height){
+    assert(operand == 0 || operand == 1);
+    if(width <= 0 || height <= 0) return;
+    mRects.push_back({lowerLeft.x, lowerLeft.y, lowerLeft.x + width, lowerLeft.y + height, operand});
+}
+
+void RectilinearBoolean::clear(){
+    mRects.clear();
+}
+
+bool RectilinearBoolean::inside(booleanOp op, int countA, int countB) const{
+    bool inA = countA > 0;
+    bool inB = countB > 0;
+    switch (op)
+    {
+    case booleanOp::OR:
+        return inA || inB;
+    case booleanOp::AND:
+        return inA && inB;
+    case booleanOp::SUB:
+        return inA && !inB;
+    case booleanOp::XOR:
+        return inA != inB;
+    default:
+        return false;
+    }
+}
+
+void RectilinearBoolean::decompose(booleanOp op, std::vector<StripRect> &strips) const{
+    strips.clear();
+
+    // (y, rect index), a rectangle enters the sweep at its bottom edge and leaves at its top edge
+    std::vector <std::pair<len_t, int>> starts, ends;
+    starts.reserve(mRects.size());
+    ends.reserve(mRects.size());
+    for(int i = 0; i < mRects.size(); ++i){
+        starts.push_back(std::make_pair(mRects[i].yl, i));
+        ends.push_back(std::make_pair(mRects[i].yh, i));
+    }
+    std::sort(starts.begin(), starts.end());
+    std::sort(ends.begin(), ends.end());
+
+    // x edges of the rectangles crossing the sweep line, sorted by x
+    struct XEdge{
+        len_t x;
+        int operand;
+        int delta;
+    };
+    struct Strip{
+        len_t xl, xh, yl;
+    };
+    std::vector <XEdge> edges;
+    std::vector <Strip> open, slab;
+
+    auto byX = [](const XEdge &e, len_t x){ return e.x < x; };
+    auto addEdge = [&edges, &byX](len_t x, int operand, int delta){
+        edges.insert(std::lower_bound(edges.begin(), edges.end(), x, byX), {x, operand, delta});
+    };
+    auto removeEdge = [&edges, &byX](len_t x, int operand, int delta){
+        std::vector<XEdge>::iterator it = std::lower_bound(edges.begin(), edges.end(), x, byX);
+        while(it != edges.end() && it->x == x && (it->operand != operand || it->delta != delta)){
+            ++it;
+        }
+        assert(it != edges.end() && it->x == x);
+        edges.erase(it);
+    };
+    auto closeStrip = [&strips](const Strip &s, len_t yh){
+        strips.push_back({Cord(s.xl, s.yl), s.xh - s.xl, yh - s.yl});
+    };
+
+    int si = 0, ei = 0;
+    while(ei < ends.size()){
+        len_t y = ends[ei].first;
+        if(si < starts.size() && starts[si].first < y) y = starts[si].first;
+
+        for(; ei < ends.size() && ends[ei].first == y; ++ei){
+            const Rect &r = mRects[ends[ei].second];
+            removeEdge(r.xl, r.operand, 1);
+            removeEdge(r.xh, r.operand, -1);
+        }
+        for(; si < starts.size() && starts[si].first == y; ++si){
+            const Rect &r = mRects[starts[si].second];
+            addEdge(r.xl, r.operand, 1);
+            addEdge(r.xh, r.operand, -1);
+        }
+
+        // classify the slab starting at y, consecutive inside runs are coalesced
+        slab.clear();
+        int count[2] = {0, 0};
+        for(int i = 0; i < edges.size(); ){
+            len_t x = edges[i].x;
+            for(; i < edges.size() && edges[i].x == x; ++i){
+                count[edges[i].operand] += edges[i].delta;
+            }
+            if(i == edges.size() || !inside(op, count[0], count[1])) continue;
+            len_t nextX = edges[i].x;
+            if(!slab.empty() && slab.back().xh == x){
+                slab.back().xh = nextX;
+            }else{
+                slab.push_back({x, nextX, y});
+            }
+        }
+
+        // strips with the same x span as in the slab below keep growing, the others are closed at y
+        int oi = 0;
+        for(Strip &s : slab){
+            while(oi < open.size() && open[oi].xl < s.xl){
+                closeStrip(open[oi++], y);
+            }
+            if(oi < open.size() && open[oi].xl == s.xl){
+                if(open[oi].xh == s.xh){
+                    s.yl = open[oi].yl;
+                }else{
+                    closeStrip(open[oi], y);
+                }
+                ++oi;
+            }
+        }
+        for(; oi < open.size(); ++oi){
+            closeStrip(open[oi], y);
+        }
+        open.swap(slab);
+    }
+    assert(open.empty() && edges.empty());
+
+    std::sort(strips.begin(), strips.end(), [](const StripRect &a, const StripRect &b){
+        if(a.lowerLeft.y != b.lowerLeft.y) return a.lowerLeft.y < b.lowerLeft.y;
+        return a.lowerLeft.x < b.lowerLeft.x;
+    });
+}
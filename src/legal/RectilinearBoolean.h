@@ -0,0 +1,44 @@
+#ifndef __RECTILINEARBOOLEAN_H__
+#define __RECTILINEARBOOLEAN_H__
+
+#include <vector>
+#include "LFUnits.h"
+
+// One rectangle of a decomposed region
+struct StripRect{
+    Cord lowerLeft;
+    len_t width;
+    len_t height;
+};
+
+enum class booleanOp{
+    OR, AND, SUB, XOR
+};
+
+// Integer boolean operations between two sets of axis aligned rectangles (operand A and operand B).
+// The result is produced directly by an edge sweep: a horizontal line moves bottom-up over the rectangle edges, the
+// x edges of the rectangles crossing it are kept sorted, so each slab is classified in one linear pass.
+// Result rectangles are maximal horizontal strips: no two share a vertical edge, and strips stacked directly on top
+// of each other always differ in x span. Strips come out ordered by their bottom edge, then left to right.
+class RectilinearBoolean{
+private:
+    struct Rect{
+        len_t xl, yl, xh, yh;
+        int operand;
+    };
+    std::vector <Rect> mRects;
+
+    bool inside(booleanOp op, int countA, int countB) const;
+
+public:
+    RectilinearBoolean();
+
+    // operand 0 is A, 1 is B. Empty rectangles are ignored
+    void insert(int operand, Cord lowerLeft, len_t width, len_t height);
+    void clear();
+
+    // Decomposes "A op B" (SUB is A - B) into maximal horizontal strips
+    void decompose(booleanOp op, std::vector<StripRect> &strips) const;
+};
+
+#endif // __RECTILINEARBOOLEAN_H__
@@ -8,19 +8,22 @@
 namespace gtl = boost::polygon;
 
 Tessera::Tessera()
-    : mType(tesseraType::EMPTY) {}
+    : mType(tesseraType::EMPTY), mTilePool(nullptr), mIndex(-1) {}
 
-Tessera::Tessera(tesseraType type, std::string name, area_t area, Cord lowerleft, len_t width, len_t height)
+Tessera::Tessera(tesseraType type, std::string name, area_t area, Cord lowerleft, len_t width, len_t height, TilePool *tilePool)
     : mType(type), mName(name), mLegalArea(area), 
-    mInitLowerLeft(lowerleft), mInitWidth(width), mInitHeight(height) {
-        Tile *defaultTess = new Tile(tileType::BLOCK, lowerleft, width, height);
+    mInitLowerLeft(lowerleft), mInitWidth(width), mInitHeight(height), mTilePool(tilePool), mIndex(-1) {
+        assert(mTilePool != nullptr);
+        Tile *defaultTess = mTilePool->allocate(tileType::BLOCK, lowerleft, width, height);
+        claimTile(defaultTess);
         TileArr.push_back(defaultTess);
         calBoundingBox();
     }
 
 Tessera::Tessera(const Tessera &other)
     : mType(other.getType()), mName(other.getName()), mLegalArea(other.getLegalArea()),
-    mInitLowerLeft(other.getInitLowerLeft()), mInitWidth(other.getInitWidth()), mInitHeight(other.getInitHeight()) {
+    mInitLowerLeft(other.getInitLowerLeft()), mInitWidth(other.getInitWidth()), mInitHeight(other.getInitHeight()),
+    mBBLowerLeft(other.mBBLowerLeft), mBBUpperRight(other.mBBUpperRight), mTilePool(other.getTilePool()), mIndex(other.getIndex()) {
         TileArr.assign(other.TileArr.begin(), other.TileArr.end());
         OverlapArr.assign(other.OverlapArr.begin(), other.OverlapArr.end());
     }
@@ -36,6 +39,12 @@ Tessera& Tessera::operator = (const Tessera &other){
     this->mInitWidth = other.getInitWidth();
     this->mInitHeight = other.getInitHeight();
 
+    this->mBBLowerLeft = other.mBBLowerLeft;
+    this->mBBUpperRight = other.mBBUpperRight;
+
+    this->mTilePool = other.getTilePool();
+    this->mIndex = other.getIndex();
+
     TileArr.assign(other.TileArr.begin(), other.TileArr.end());
     OverlapArr.assign(other.OverlapArr.begin(), other.OverlapArr.end());
     
@@ -75,6 +84,31 @@ tesseraType Tessera::getType () const{
     return this->mType;
 }
 
+TilePool *Tessera::getTilePool() const{
+    return this->mTilePool;
+}
+
+void Tessera::setTilePool(TilePool *tilePool){
+    this->mTilePool = tilePool;
+}
+
+int Tessera::getIndex() const{
+    return this->mIndex;
+}
+
+void Tessera::setIndex(int index){
+    this->mIndex = index;
+    for(Tile *tile : TileArr){
+        claimTile(tile);
+    }
+}
+
+void Tessera::claimTile(Tile *tile) const{
+    assert(tile->getType() == tileType::BLOCK);
+    tile->OwnerFixedTesseraIdx = (mType == tesseraType::HARD) ? mIndex : -1;
+    tile->OwnerSoftTesseraIdx = (mType == tesseraType::SOFT) ? mIndex : -1;
+}
+
 Cord Tessera::getInitLowerLeft () const{
     return this->mInitLowerLeft;
 }
@@ -211,6 +245,7 @@ int Tessera::insertTiles(Tile *tile){
     switch (tile->getType()){
         case tileType::BLOCK:
             /* code */
+            claimTile(tile);
             TileArr.push_back(tile);
             break;
         case tileType::OVERLAP:
@@ -262,179 +297,48 @@ void Tessera::splitRectliearDueToOverlap(){
     You don't have to maintain *up *donw *left right pointers, they will be taken care of when insertion happen
     */
 
-    // if overlap exists, default tile will always be split
-    // delete default tile, insert tile size of block
-    if (OverlapArr.size() > 0 ){
-        Tile* defaultTile = TileArr.back();
-        Cord lowerLeft = defaultTile->getLowerLeft();
-        len_t width = defaultTile->getWidth();
-        len_t height = defaultTile->getHeight();
-        // Do I need to delete pointer????
-        delete defaultTile; 
-        Tile* newDefault = new Tile(tileType::BLOCK, lowerLeft, width, height);
-        TileArr[0] = newDefault;
+    std::vector<StripRect> strips;
+    if (computeSplitStrips(strips)){
+        applySplitStrips(strips);
     }
-    
-
-    // iterate thru all overlaps
-    for (int o = 0; o < OverlapArr.size(); o++){
-        std::vector <Tile *> influencedTiles;
-        Tile* currentOverlap = OverlapArr[o];
-        int overlapRightBoundary = currentOverlap->getUpperRight().x;
-        int overlapUpperBoundary = currentOverlap->getUpperRight().y;
-        int overlapLeftBoundary = currentOverlap->getLowerLeft().x;
-        int overlapLowerBoundary = currentOverlap->getLowerLeft().y;
-
-        // step 1: find all block Tiles that will be influenced
-        for (int t = 0; t < TileArr.size(); ++t){
-            // check overlap
-            bool xOverlap = TileArr[t]->getLowerLeft().x < currentOverlap->getUpperRight().x &&
-                            currentOverlap->getLowerLeft().x < TileArr[t]->getUpperRight().x;
-            bool yOverlap = TileArr[t]->getLowerLeft().y < currentOverlap->getUpperRight().y &&
-                            currentOverlap->getLowerLeft().y < TileArr[t]->getUpperRight().y;
-            if (xOverlap && yOverlap){
-                influencedTiles.push_back(TileArr[t]);
-            }
-        }
-
-        // step 2: find Tiles that include the upper/lower boundary of overlap,  
-        // split those tiles
-        for (int i = 0; i < influencedTiles.size(); ++i){
-            Tile* currentTile = influencedTiles[i];
-            int currentRightBoundary = currentTile->getUpperRight().x;
-            int currentUpperBoundary = currentTile->getUpperRight().y;
-            int currentLeftBoundary = currentTile->getLowerLeft().x;
-            int currentLowerBoundary = currentTile->getLowerLeft().y;
-            bool includeUpperBoundary = currentLowerBoundary < overlapUpperBoundary && overlapUpperBoundary < currentUpperBoundary;
-            if (includeUpperBoundary){
-                // change hieght of currentTile, add a new tile to tile array
-                Cord newLL = Cord(currentLeftBoundary, overlapUpperBoundary);
-                int newWidth = currentTile->getWidth();
-                int newHeight = currentUpperBoundary - overlapUpperBoundary;
-                Tile* newTile = new Tile(tileType::BLOCK, newLL, newWidth, newHeight);
-                TileArr.push_back(newTile);
-
-                int alterHeight = overlapUpperBoundary - currentLowerBoundary;
-                currentTile->setHeight(alterHeight);
-                currentUpperBoundary = currentTile->getUpperRight().y;
-            }
-
-            bool includeLowerBoundary = currentLowerBoundary < overlapLowerBoundary && overlapLowerBoundary < currentUpperBoundary;
-            if (includeLowerBoundary){
-                // change LL and height of currentTile, add a new tile to tile array
-                Cord newLL = Cord(currentLeftBoundary, currentLowerBoundary);
-                int newWidth = currentTile->getWidth();
-                int newHeight = overlapLowerBoundary - currentLowerBoundary;
-                Tile* newTile = new Tile(tileType::BLOCK, newLL, newWidth, newHeight);
-                TileArr.push_back(newTile);
-
-                int alterHeight = currentUpperBoundary - overlapLowerBoundary;
-                Cord alterLL = Cord(currentLeftBoundary, overlapLowerBoundary);
-                currentTile->setHeight(alterHeight);
-                currentTile->setLowerLeft(alterLL);
-            }
-        }
-
-        // step 3: split all influenced tiles into 2 segments (left, right) if possible
-        for (int i = 0; i < influencedTiles.size(); ++i){
-            Tile* currentTile = influencedTiles[i];
-            int currentRightBoundary = currentTile->getUpperRight().x;
-            int currentUpperBoundary = currentTile->getUpperRight().y;
-            int currentLeftBoundary = currentTile->getLowerLeft().x;
-            int currentLowerBoundary = currentTile->getLowerLeft().y;
-            bool includeLeftBoundary = currentLeftBoundary < overlapLeftBoundary && overlapLeftBoundary < currentRightBoundary;
-            bool includeRightBoundary = currentLeftBoundary < overlapRightBoundary && overlapRightBoundary < currentRightBoundary;
-
-            // case 1: tile only includes left boundary
-            // shrink tile width
-            if (includeLeftBoundary && !includeRightBoundary){
-                int alterWidth = overlapLeftBoundary - currentLeftBoundary;
-                currentTile->setWidth(alterWidth);
-            }
-            // case 2: tile only includes right boundary
-            // adjust LL and shrink tile width
-            else if (!includeLeftBoundary && includeRightBoundary){
-                Cord alterLL = Cord(overlapRightBoundary, currentLowerBoundary);
-                int alterWidth = currentRightBoundary - overlapRightBoundary;
-                currentTile->setLowerLeft(alterLL);
-                currentTile->setWidth(alterWidth);
-            }
-            // case 3: tile includes entire overlap interval 
-            // shrink tile width, create new tile
-            else if (includeLeftBoundary && includeRightBoundary){
-                int alterWidth = overlapLeftBoundary - currentLeftBoundary;
-                currentTile->setWidth(alterWidth);
-
-                Cord newLL = Cord(overlapRightBoundary, currentLowerBoundary);
-                int newWidth = currentRightBoundary - overlapRightBoundary;
-                int newHeight = currentTile->getHeight();
-                Tile* newTile = new Tile(tileType::BLOCK, newLL, newWidth, newHeight);
-                TileArr.push_back(newTile);
-                // influencedTiles.push_back(newTile);
-            }
-            // case 4: overlap is same size or wider than tile
-            // reduce width to 0, will clean up later
-            else {
-                currentTile->setWidth(0);
-            }
-        }
+}
 
-        // step 4: merge up down neighboring tiles with same width 
-        for (int t1 = 0; t1 < TileArr.size(); ++t1){
-            Tile* tile1 = TileArr[t1];
-            if (tile1->getWidth() == 0){
-                continue;
-            }
-            for (int t2 = 0; t2 < TileArr.size(); ++t2){
-                Tile* tile2 = TileArr[t2];
-                if (tile1 == tile2 || tile2->getWidth() == 0){
-                    continue;
-                }
-                // 1 is on top of 2
-                bool canMerge1 = (tile1->getLowerLeft() == tile2->getUpperLeft()) && (tile1->getLowerRight() == tile2->getUpperRight()); 
-                // 2 is on top of 1
-                bool canMerge2 = (tile1->getUpperLeft() == tile2->getLowerLeft()) && (tile2->getLowerRight() == tile1->getUpperRight()); 
-                
-                // shrink 2, expand 1
-                if (canMerge1){
-                    Cord alterLL = tile2->getLowerLeft();
-                    int alterHeight = tile1->getHeight() + tile2->getHeight();
-                    tile1->setLowerLeft(alterLL);
-                    tile1->setHeight(alterHeight);
-
-                    tile2->setWidth(0);
-                }
-                else if (canMerge2){
-                    int alterHeight = tile1->getHeight() + tile2->getHeight();
-                    tile1->setHeight(alterHeight);
-
-                    tile2->setWidth(0);
-                }
-            }
-        }
+bool Tessera::computeSplitStrips(std::vector<StripRect> &strips) const{
+    strips.clear();
+    if (OverlapArr.size() == 0){
+        return false;
+    }
 
-        // step 5: clean up, remove tiles with 0 width
-        std::vector<Tile*> deleteTiles;
-        for (auto it = TileArr.begin(); it != TileArr.end(); it++){
-            if ((*it)->getWidth() == 0){
-                deleteTiles.push_back(*it);
-                TileArr.erase(it);
-                it--;
-            }
-        }
+    // what is left of the block once every overlap is carved out, as maximal horizontal strips
+    RectilinearBoolean kernel;
+    for (Tile *tile : TileArr){
+        kernel.insert(0, tile->getLowerLeft(), tile->getWidth(), tile->getHeight());
+    }
+    for (Tile *overlap : OverlapArr){
+        kernel.insert(1, overlap->getLowerLeft(), overlap->getWidth(), overlap->getHeight());
+    }
+    kernel.decompose(booleanOp::SUB, strips);
+    return true;
+}
 
-        for (int i = 0; i < deleteTiles.size(); i++){
-            delete deleteTiles[i];
-        }
+void Tessera::applySplitStrips(const std::vector<StripRect> &strips){
+    // the old tiles are dropped, the strips replace them
+    for (Tile *tile : TileArr){
+        mTilePool->release(tile);
+    }
+    TileArr.clear();
+    for (const StripRect &strip : strips){
+        Tile *newTile = mTilePool->allocate(tileType::BLOCK, strip.lowerLeft, strip.width, strip.height);
+        claimTile(newTile);
+        TileArr.push_back(newTile);
     }
-    
 }
 
 void Tessera::printCorners(std::ostream& fout){
-    typedef gtl::polygon_data<int> Polygon;
-    typedef gtl::polygon_90_data<int> Polygon90;
+    typedef gtl::polygon_data<len_t> Polygon;
+    typedef gtl::polygon_90_data<len_t> Polygon90;
     typedef gtl::polygon_traits<Polygon90>::point_type Point;
-    typedef std::vector<gtl::polygon_90_data<int>> Polygon90Set;
+    typedef std::vector<gtl::polygon_90_data<len_t>> Polygon90Set;
 
     // added by ryan
     if (this->getLegalArea() == 0){
@@ -446,11 +350,11 @@ void Tessera::printCorners(std::ostream& fout){
         return;
     }
 
-    gtl::polygon_90_set_data<int> polygonSet;
+    gtl::polygon_90_set_data<len_t> polygonSet;
 
     for (int i = 0; i < TileArr.size(); ++i){
         Tile* currentTile = TileArr[i];
-        gtl::polygon_90_data<int> boxPolygon;
+        gtl::polygon_90_data<len_t> boxPolygon;
         const Point box[4] = {
             gtl::construct<Point>(currentTile->getLowerLeft().x, currentTile->getLowerLeft().y),
             gtl::construct<Point>(currentTile->getUpperLeft().x, currentTile->getUpperLeft().y),
@@ -462,7 +366,7 @@ void Tessera::printCorners(std::ostream& fout){
         gtl::operators::operator+=(polygonSet, boxPolygon); 
     }
 
-    std::vector<gtl::polygon_data<int>> polySetUnionized;
+    std::vector<gtl::polygon_data<len_t>> polySetUnionized;
     polySetUnionized.clear();
     polygonSet.get_polygons(polySetUnionized);
 
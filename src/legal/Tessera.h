@@ -7,6 +7,8 @@
 
 #include "LFUnits.h"
 #include "Tile.h"
+#include "TilePool.h"
+#include "RectilinearBoolean.h"
 
 
 enum class tesseraType{
@@ -26,6 +28,12 @@ private:
     
     Cord mBBLowerLeft;
     Cord mBBUpperRight;
+
+    // pool that owns every tile this Tessera creates, shared with the LFLegaliser
+    TilePool *mTilePool;
+
+    // position inside LFLegaliser::fixedTesserae (HARD) or softTesserae (SOFT), -1 until registered
+    int mIndex;
     
 
 
@@ -36,7 +44,7 @@ public:
     std::vector <Tile *> OverlapArr;
 
     Tessera();
-    Tessera(tesseraType type, std::string name, area_t area, Cord lowerleft, len_t width, len_t height);
+    Tessera(tesseraType type, std::string name, area_t area, Cord lowerleft, len_t width, len_t height, TilePool *tilePool);
     Tessera(const Tessera &other);
 
     Tessera& operator = (const Tessera &other);
@@ -46,6 +54,13 @@ public:
     std::string getName () const;
     area_t getLegalArea () const;
     tesseraType getType() const;
+    TilePool *getTilePool() const;
+    void setTilePool(TilePool *tilePool);
+    int getIndex() const;
+    // Registers the position of this Tessera inside its LFLegaliser array, every tile in TileArr is re-claimed
+    void setIndex(int index);
+    // Stamps this Tessera as the owner of a BLOCK tile, must be called whenever a tile is added to TileArr
+    void claimTile(Tile *tile) const;
     Cord getInitLowerLeft () const;
     len_t  getInitWidth () const;
     len_t getInitHeight () const;
@@ -66,6 +81,11 @@ public:
 
     int insertTiles(Tile *tile);
     void splitRectliearDueToOverlap();
+    // The two halves of splitRectliearDueToOverlap. computeSplitStrips only reads TileArr and OverlapArr, so it may run
+    // on several Tesserae concurrently; applySplitStrips touches the TilePool and must be called from one thread.
+    // Returns false if there is nothing to split
+    bool computeSplitStrips(std::vector<StripRect> &strips) const;
+    void applySplitStrips(const std::vector<StripRect> &strips);
 
     void printCorners(std::ostream &fout);
 
@@ -1,17 +1,18 @@
 #include <iostream>
 #include "Tile.h"
+#include "RectilinearBoolean.h"
 
 Tile::Tile()
-    : type(tileType::BLANK), mLowerLeft(Cord(0,0)), mWidth(0), mHeight(0),
-        rt(nullptr), tr(nullptr), bl(nullptr), lb(nullptr) {}
+    : type(tileType::BLANK), mLowerLeft(Cord(0,0)), mWidth(0), mHeight(0), mHandle(NULL_HANDLE),
+        OwnerFixedTesseraIdx(-1), OwnerSoftTesseraIdx(-1), rt(nullptr), tr(nullptr), bl(nullptr), lb(nullptr), visitStamp(0) {}
 
 Tile::Tile(tileType t, Cord LL, len_t w, len_t h) 
-    : type(t), mLowerLeft(LL), mWidth(w), mHeight(h),
-        rt(nullptr), tr(nullptr), bl(nullptr), lb(nullptr) {}
+    : type(t), mLowerLeft(LL), mWidth(w), mHeight(h), mHandle(NULL_HANDLE),
+        OwnerFixedTesseraIdx(-1), OwnerSoftTesseraIdx(-1), rt(nullptr), tr(nullptr), bl(nullptr), lb(nullptr), visitStamp(0) {}
 
 Tile::Tile(const Tile &other)
-    : type(other.type), mLowerLeft(other.getLowerLeft()), mWidth(other.getWidth()), mHeight(other.getHeight()),
-        rt(other.rt), tr(other.tr), bl(other.bl), lb(other.lb) {
+    : type(other.type), mLowerLeft(other.getLowerLeft()), mWidth(other.getWidth()), mHeight(other.getHeight()), mHandle(NULL_HANDLE),
+        OwnerFixedTesseraIdx(other.OwnerFixedTesseraIdx), OwnerSoftTesseraIdx(other.OwnerSoftTesseraIdx), rt(other.rt), tr(other.tr), bl(other.bl), lb(other.lb), visitStamp(0) {
             this->OverlapFixedTesseraeIdx.assign(other.OverlapFixedTesseraeIdx.begin(), other.OverlapFixedTesseraeIdx.end());
             this->OverlapSoftTesseraeIdx.assign(other.OverlapSoftTesseraeIdx.begin(), other.OverlapSoftTesseraeIdx.end());
         }
@@ -19,6 +20,7 @@ Tile::Tile(const Tile &other)
 Tile& Tile::operator = (const Tile &other){
     if(this == &other) return (*this);
 
+    // mHandle and visitStamp belong to the storage slot and are left untouched
     this->type = other.getType();
     this->mLowerLeft = other.getLowerLeft();
     this->mWidth = other.getWidth();
@@ -31,6 +33,8 @@ Tile& Tile::operator = (const Tile &other){
 
     this->OverlapFixedTesseraeIdx.assign(other.OverlapFixedTesseraeIdx.begin(), other.OverlapFixedTesseraeIdx.end());
     this->OverlapSoftTesseraeIdx.assign(other.OverlapSoftTesseraeIdx.begin(), other.OverlapSoftTesseraeIdx.end());
+    this->OwnerFixedTesseraIdx = other.OwnerFixedTesseraIdx;
+    this->OwnerSoftTesseraIdx = other.OwnerSoftTesseraIdx;
 
     return (*this);
 }
@@ -42,6 +46,10 @@ void Tile::setType(tileType type) {
 tileType Tile::getType() const {
     return this->type;
 }
+
+unsigned int Tile::getHandle() const {
+    return this->mHandle;
+}
 Cord Tile::getLowerLeft() const {
     return this->mLowerLeft;
 };
@@ -83,7 +91,7 @@ float Tile::getAspectRatio() const {
 };
 
 area_t Tile::getArea() const {
-    return this->mWidth * this->mHeight;
+    return (area_t) this->mWidth * this->mHeight;
 };
 
 bool Tile::operator == (const Tile &comp) const{
@@ -179,104 +187,45 @@ std::ostream &operator << (std::ostream &o, const PolygonSet &polys) {
     return o;
 }
 
-std::vector<Tile> cutTile(Tile bigTile, Tile smallTile) {
-    using namespace boost::polygon::operators;
-    Rectangle bigRect(bigTile.getLowerLeft().x, bigTile.getLowerLeft().y, bigTile.getUpperRight().x, bigTile.getUpperRight().y);
-    Rectangle smallRect(smallTile.getLowerLeft().x, smallTile.getLowerLeft().y, smallTile.getUpperRight().x, smallTile.getUpperRight().y);
-    PolygonSet cutPoly;
-    cutPoly += bigRect - smallRect;
-
-    std::vector<Tile> cuttedTiles;
-    std::set<len_t> yCord;
-
-    for ( Polygon &poly : cutPoly ) {
-        for ( const Point &point : poly ) {
-            yCord.insert(point.y());
-        }
-        std::vector<len_t> yCordVec(yCord.begin(), yCord.end());
-        std::sort(yCordVec.begin(), yCordVec.end());
-        for ( int i = 0; i < yCordVec.size() - 1; i++ ) {
-            int lowY = yCordVec[i];
-            int highY = yCordVec[i + 1];
-            Rectangle mask(0, lowY, 100000000, highY);
-            PolygonSet maskedPoly;
-            maskedPoly += poly & mask;
-
-            Rectangle maskedRect;
-            gtl::extents(maskedRect, maskedPoly);
-            cuttedTiles.push_back(Tile(tileType::OVERLAP, Cord(gtl::xl(maskedRect), gtl::yl(maskedRect)), gtl::xh(maskedRect) - gtl::xl(maskedRect), gtl::yh(maskedRect) - gtl::yl(maskedRect)));
-        }
+static std::vector<Tile> stripsToTiles(const std::vector<StripRect> &strips) {
+    std::vector<Tile> tiles;
+    tiles.reserve(strips.size());
+    for ( const StripRect &strip : strips ) {
+        tiles.push_back(Tile(tileType::OVERLAP, strip.lowerLeft, strip.width, strip.height));
     }
+    return tiles;
+}
+
+std::vector<Tile> cutTile(Tile bigTile, Tile smallTile) {
+    RectilinearBoolean kernel;
+    kernel.insert(0, bigTile.getLowerLeft(), bigTile.getWidth(), bigTile.getHeight());
+    kernel.insert(1, smallTile.getLowerLeft(), smallTile.getWidth(), smallTile.getHeight());
 
-    return cuttedTiles;
+    std::vector<StripRect> strips;
+    kernel.decompose(booleanOp::SUB, strips);
+    return stripsToTiles(strips);
 }
 
 std::vector<Tile> mergeTile(Tile tile1, Tile tile2) {
-    using namespace boost::polygon::operators;
-    Rectangle rect1(tile1.getLowerLeft().x, tile1.getLowerLeft().y, tile1.getUpperRight().x, tile1.getUpperRight().y);
-    Rectangle rect2(tile2.getLowerLeft().x, tile2.getLowerLeft().y, tile2.getUpperRight().x, tile2.getUpperRight().y);
-    PolygonSet mergePoly;
-    mergePoly += rect1 + rect2;
-
-    std::vector<Tile> mergedTiles;
-    std::set<len_t> yCord;
-
-    for ( Polygon &poly : mergePoly ) {
-        for ( const Point &point : poly ) {
-            yCord.insert(point.y());
-        }
-        std::vector<len_t> yCordVec(yCord.begin(), yCord.end());
-        std::sort(yCordVec.begin(), yCordVec.end());
-        for ( int i = 0; i < yCordVec.size() - 1; i++ ) {
-            int lowY = yCordVec[i];
-            int highY = yCordVec[i + 1];
-            Rectangle mask(0, lowY, 100000000, highY);
-            PolygonSet maskedPoly;
-            maskedPoly += poly & mask;
-
-            Rectangle maskedRect;
-            gtl::extents(maskedRect, maskedPoly);
-            mergedTiles.push_back(Tile(tileType::OVERLAP, Cord(gtl::xl(maskedRect), gtl::yl(maskedRect)), gtl::xh(maskedRect) - gtl::xl(maskedRect), gtl::yh(maskedRect) - gtl::yl(maskedRect)));
-        }
-    }
+    RectilinearBoolean kernel;
+    kernel.insert(0, tile1.getLowerLeft(), tile1.getWidth(), tile1.getHeight());
+    kernel.insert(0, tile2.getLowerLeft(), tile2.getWidth(), tile2.getHeight());
 
-    return mergedTiles;
+    std::vector<StripRect> strips;
+    kernel.decompose(booleanOp::OR, strips);
+    return stripsToTiles(strips);
 }
 
 std::vector<Tile> mergeCutTiles(std::vector<Tile> toMerge, std::vector<Tile> toCut) {
-    using namespace boost::polygon::operators;
-
-    PolygonSet manipPoly;
+    RectilinearBoolean kernel;
     for ( auto &tile : toMerge ) {
-        Rectangle mergeRect(tile.getLowerLeft().x, tile.getLowerLeft().y, tile.getUpperRight().x, tile.getUpperRight().y);
-        manipPoly += mergeRect;
+        kernel.insert(0, tile.getLowerLeft(), tile.getWidth(), tile.getHeight());
     }
     for ( auto &tile : toCut ) {
-        Rectangle cutRect(tile.getLowerLeft().x, tile.getLowerLeft().y, tile.getUpperRight().x, tile.getUpperRight().y);
-        manipPoly -= cutRect;
-    }
-
-    std::vector<Tile> manipTiles;
-    std::set<len_t> yCord;
-
-    for ( Polygon &poly : manipPoly ) {
-        for ( const Point &point : poly ) {
-            yCord.insert(point.y());
-        }
-        std::vector<len_t> yCordVec(yCord.begin(), yCord.end());
-        std::sort(yCordVec.begin(), yCordVec.end());
-        for ( int i = 0; i < yCordVec.size() - 1; i++ ) {
-            int lowY = yCordVec[i];
-            int highY = yCordVec[i + 1];
-            Rectangle mask(0, lowY, 100000000, highY);
-            PolygonSet maskedPoly;
-            maskedPoly += poly & mask;
-
-            Rectangle maskedRect;
-            gtl::extents(maskedRect, maskedPoly);
-            manipTiles.push_back(Tile(tileType::OVERLAP, Cord(gtl::xl(maskedRect), gtl::yl(maskedRect)), gtl::xh(maskedRect) - gtl::xl(maskedRect), gtl::yh(maskedRect) - gtl::yl(maskedRect)));
-        }
+        kernel.insert(1, tile.getLowerLeft(), tile.getWidth(), tile.getHeight());
     }
 
-    return manipTiles;
+    std::vector<StripRect> strips;
+    kernel.decompose(booleanOp::SUB, strips);
+    return stripsToTiles(strips);
 }
\ No newline at end of file
@@ -30,11 +30,26 @@ private:
     len_t mWidth;
     len_t mHeight;
 
+    // index inside the owning TilePool, NULL_HANDLE for tiles not allocated through a pool
+    unsigned int mHandle;
+    friend class TilePool;
+
 public:
+    static const unsigned int NULL_HANDLE = 0xFFFFFFFFu;
+
     std::vector <int> OverlapFixedTesseraeIdx;
     std::vector <int> OverlapSoftTesseraeIdx;
 
+    // owner of a BLOCK tile, index into fixedTesserae / softTesserae (at most one of them >= 0), -1 for the others.
+    // Set by Tessera::claimTile whenever the tile enters a TileArr
+    int OwnerFixedTesseraIdx;
+    int OwnerSoftTesseraIdx;
+
     Tile *rt, *tr, *bl, *lb;
+
+    // visit marker used by LFLegaliser plane walks, a tile is visited in the current walk iff visitStamp == walk epoch
+    // 64-bit so the epoch never wraps and stamps never need clearing
+    unsigned long long visitStamp;
     
     Tile();
     Tile(tileType t, Cord LL, len_t w, len_t h);
@@ -44,6 +59,7 @@ public:
     friend std::ostream &operator << (std::ostream &os, const Tile &t);
     
     tileType getType() const;
+    unsigned int getHandle() const;
 
     Cord getLowerLeft() const;
     Cord getUpperLeft() const;
@@ -92,6 +108,7 @@ std::ostream &operator << (std::ostream &o, const Polygon &poly);
 std::ostream &operator << (std::ostream &o, const PolygonSet &polys);
 
 // * These are new added functions for tile manipulation
+// Results are maximal horizontal strips (see RectilinearBoolean), returned as OVERLAP tiles without stitches
 std::vector<Tile> cutTile(Tile bigTile, Tile smallTile);
 std::vector<Tile> mergeTile(Tile tile1, Tile tile2);
 std::vector<Tile> mergeCutTiles(std::vector<Tile> toMerge, std::vector<Tile> toCut);
@@ -0,0 +1,86 @@
+#include <assert.h>
+#include <algorithm>
+#include "TileNodeIndex.h"
+
+TileNodeIndex::TileNodeIndex()
+    : mSpillUsed(0), mStamp(1) {}
+
+void TileNodeIndex::clear(){
+    mSpillUsed = 0;
+    ++mStamp;
+    if(mStamp == 0){
+        // the stamp wrapped around, stale slots could look current again
+        for(Slot &slot : mSlots){
+            slot.stamp = 0;
+        }
+        mStamp = 1;
+    }
+}
+
+void TileNodeIndex::insert(const Tile *tile, int nodeIndex){
+    assert(tile != nullptr);
+    unsigned int handle = tile->getHandle();
+    // only pool tiles have a handle to index by
+    assert(handle != Tile::NULL_HANDLE);
+    if(handle >= mSlots.size()){
+        mSlots.resize(handle + 1, Slot{0, 0, -1, {}});
+    }
+
+    Slot &slot = mSlots[handle];
+    if(slot.stamp != mStamp){
+        slot.stamp = mStamp;
+        slot.count = 0;
+        slot.spill = -1;
+    }
+
+    if(slot.spill == -1 && slot.count < INLINE_NODES){
+        slot.nodes[slot.count] = nodeIndex;
+    }else{
+        if(slot.spill == -1){
+            slot.spill = mSpillUsed++;
+            if(slot.spill == mSpill.size()){
+                mSpill.push_back(std::vector<int>());
+            }
+            mSpill[slot.spill].assign(slot.nodes, slot.nodes + INLINE_NODES);
+        }
+        mSpill[slot.spill].push_back(nodeIndex);
+    }
+    ++slot.count;
+}
+
+void TileNodeIndex::erase(const Tile *tile, int nodeIndex){
+    unsigned int handle = tile->getHandle();
+    if(handle >= mSlots.size() || mSlots[handle].stamp != mStamp){
+        return;
+    }
+
+    Slot &slot = mSlots[handle];
+    int *first = slot.nodes;
+    if(slot.spill != -1){
+        first = mSpill[slot.spill].data();
+    }
+    int *last = first + slot.count;
+    int *it = std::find(first, last, nodeIndex);
+    if(it == last) return;
+
+    // insertion order of the remaining nodes is kept
+    std::copy(it + 1, last, it);
+    --slot.count;
+    if(slot.spill != -1){
+        mSpill[slot.spill].pop_back();
+    }
+}
+
+TileNodeIndex::NodeRange TileNodeIndex::find(const Tile *tile) const{
+    unsigned int handle = tile->getHandle();
+    if(handle >= mSlots.size() || mSlots[handle].stamp != mStamp){
+        return NodeRange{nullptr, nullptr};
+    }
+
+    const Slot &slot = mSlots[handle];
+    if(slot.spill == -1){
+        return NodeRange{slot.nodes, slot.nodes + slot.count};
+    }
+    const std::vector<int> &spilled = mSpill[slot.spill];
+    return NodeRange{spilled.data(), spilled.data() + spilled.size()};
+}
@@ -0,0 +1,47 @@
+#ifndef __TILENODEINDEX_H__
+#define __TILENODEINDEX_H__
+
+#include <vector>
+#include "Tile.h"
+
+// Tile -> graph node lookup, stored densely by tile handle.
+// A tile belongs to a few nodes at most (blocks and blanks to one, an overlap tile to one node per pair of owners), so
+// the first INLINE_NODES node indices live inside the slot itself and only crowded tiles spill into a side list.
+// Slots are stamped with the epoch of the last clear() and spill lists are recycled with their capacity, so clearing
+// touches neither and is O(1), except for one pass resetting every stamp when the epoch counter wraps around.
+class TileNodeIndex{
+private:
+    static const int INLINE_NODES = 2;
+
+    struct Slot{
+        unsigned int stamp;
+        int count;
+        // index into mSpill once count > INLINE_NODES, every node of the tile is then kept there
+        int spill;
+        int nodes[INLINE_NODES];
+    };
+    std::vector <Slot> mSlots;
+    // only the first mSpillUsed lists belong to the current epoch, the others wait to be reused
+    std::vector <std::vector<int>> mSpill;
+    int mSpillUsed;
+    unsigned int mStamp;
+
+public:
+    // [begin, end) over the node indices of one tile, in insertion order
+    struct NodeRange{
+        const int *first;
+        const int *last;
+        const int *begin() const { return first; }
+        const int *end() const { return last; }
+    };
+
+    TileNodeIndex();
+
+    void clear();
+    void insert(const Tile *tile, int nodeIndex);
+    // removes one node of the tile, a no-op if the tile is not in it
+    void erase(const Tile *tile, int nodeIndex);
+    NodeRange find(const Tile *tile) const;
+};
+
+#endif // __TILENODEINDEX_H__
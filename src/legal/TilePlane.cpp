@@ -0,0 +1,235 @@
+#include <assert.h>
+#include "TilePlane.h"
+
+TilePlane::TilePlane()
+    : mPool(nullptr), mVersion(0), mBuilt(false) {}
+
+unsigned int TilePlane::toIndex(const Tile *tile) const{
+    return (tile == nullptr) ? NULL_INDEX : tile->getHandle();
+}
+
+void TilePlane::build(const TilePool &pool, unsigned long long version){
+    unsigned int capacity = pool.getCapacity();
+    mPool = &pool;
+
+    mX.resize(capacity);
+    mY.resize(capacity);
+    mW.resize(capacity);
+    mH.resize(capacity);
+    mRt.resize(capacity);
+    mTr.resize(capacity);
+    mBl.resize(capacity);
+    mLb.resize(capacity);
+    mType.resize(capacity);
+    mOwner.resize(capacity);
+
+    for(unsigned int i = 0; i < capacity; ++i){
+        if(!pool.isInUse(i)){
+            mType[i] = TYPE_FREE;
+            mRt[i] = mTr[i] = mBl[i] = mLb[i] = NULL_INDEX;
+            mOwner[i] = -1;
+            continue;
+        }
+        const Tile *t = pool.getTile(i);
+        Cord LL = t->getLowerLeft();
+        mX[i] = LL.x;
+        mY[i] = LL.y;
+        mW[i] = t->getWidth();
+        mH[i] = t->getHeight();
+        mRt[i] = toIndex(t->rt);
+        mTr[i] = toIndex(t->tr);
+        mBl[i] = toIndex(t->bl);
+        mLb[i] = toIndex(t->lb);
+
+        unsigned char type = (unsigned char) t->getType();
+        if(t->OwnerFixedTesseraIdx >= 0){
+            mType[i] = type | OWNER_FIXED_BIT;
+            mOwner[i] = t->OwnerFixedTesseraIdx;
+        }else{
+            mType[i] = type;
+            mOwner[i] = t->OwnerSoftTesseraIdx;
+        }
+    }
+
+    mVersion = version;
+    mBuilt = true;
+}
+
+void TilePlane::clear(){
+    mX.clear();
+    mY.clear();
+    mW.clear();
+    mH.clear();
+    mRt.clear();
+    mTr.clear();
+    mBl.clear();
+    mLb.clear();
+    mType.clear();
+    mOwner.clear();
+    mPool = nullptr;
+    mBuilt = false;
+}
+
+bool TilePlane::isCurrent(unsigned long long version) const{
+    return mBuilt && (mVersion == version);
+}
+
+unsigned int TilePlane::size() const{
+    return mType.size();
+}
+
+Tile *TilePlane::getTile(unsigned int index) const{
+    assert(mPool != nullptr);
+    return mPool->getTile(index);
+}
+
+bool TilePlane::isInUse(unsigned int index) const{
+    return (index < mType.size()) && (mType[index] != TYPE_FREE);
+}
+
+tileType TilePlane::getType(unsigned int index) const{
+    assert(isInUse(index));
+    return (tileType) (mType[index] & ~OWNER_FIXED_BIT);
+}
+
+int TilePlane::getOwner(unsigned int index, bool &isFixed) const{
+    assert(isInUse(index));
+    isFixed = (mType[index] & OWNER_FIXED_BIT) != 0;
+    return mOwner[index];
+}
+
+unsigned int TilePlane::findPoint(const Cord &key, unsigned int start) const{
+    unsigned int index = start;
+    while(true){
+        assert(index != NULL_INDEX);
+        bool yIn = (key.y >= mY[index]) && (key.y < mY[index] + mH[index]);
+        if(!yIn){
+            // Adjust vertical range
+            index = (key.y >= mY[index]) ? mRt[index] : mLb[index];
+            continue;
+        }
+        bool xIn = (key.x >= mX[index]) && (key.x < mX[index] + mW[index]);
+        if(xIn) return index;
+        // Vertical range correct! adjust horizontal range
+        index = (key.x >= mX[index]) ? mTr[index] : mBl[index];
+    }
+}
+
+// The four neighbor walks, "emit" receives the handle of every neighbor in walk order
+namespace {
+
+template <typename Emit>
+void walkTop(const TilePlane &p, unsigned int centre, Emit emit){
+    unsigned int n = p.rt(centre);
+    if(n == TilePlane::NULL_INDEX) return;
+    while(p.x(n) > p.x(centre)){
+        emit(n);
+        n = p.bl(n);
+    }
+    emit(n);
+}
+
+template <typename Emit>
+void walkDown(const TilePlane &p, unsigned int centre, Emit emit){
+    unsigned int n = p.lb(centre);
+    if(n == TilePlane::NULL_INDEX) return;
+    len_t centreRight = p.x(centre) + p.w(centre);
+    while(p.x(n) + p.w(n) < centreRight){
+        emit(n);
+        n = p.tr(n);
+    }
+    emit(n);
+}
+
+template <typename Emit>
+void walkLeft(const TilePlane &p, unsigned int centre, Emit emit){
+    unsigned int n = p.bl(centre);
+    if(n == TilePlane::NULL_INDEX) return;
+    len_t centreTop = p.y(centre) + p.h(centre);
+    while(p.y(n) + p.h(n) < centreTop){
+        emit(n);
+        n = p.rt(n);
+    }
+    emit(n);
+}
+
+template <typename Emit>
+void walkRight(const TilePlane &p, unsigned int centre, Emit emit){
+    unsigned int n = p.tr(centre);
+    if(n == TilePlane::NULL_INDEX) return;
+    while(p.y(n) > p.y(centre)){
+        emit(n);
+        n = p.lb(n);
+    }
+    emit(n);
+}
+
+}
+
+void TilePlane::findTopNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const{
+    walkTop(*this, centre, [&neighbors](unsigned int n){ neighbors.push_back(n); });
+}
+
+void TilePlane::findDownNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const{
+    walkDown(*this, centre, [&neighbors](unsigned int n){ neighbors.push_back(n); });
+}
+
+void TilePlane::findLeftNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const{
+    walkLeft(*this, centre, [&neighbors](unsigned int n){ neighbors.push_back(n); });
+}
+
+void TilePlane::findRightNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const{
+    walkRight(*this, centre, [&neighbors](unsigned int n){ neighbors.push_back(n); });
+}
+
+void TilePlane::findTopNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const{
+    walkTop(*this, centre, [this, &neighbors](unsigned int n){ neighbors.push_back(mPool->getTile(n)); });
+}
+
+void TilePlane::findDownNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const{
+    walkDown(*this, centre, [this, &neighbors](unsigned int n){ neighbors.push_back(mPool->getTile(n)); });
+}
+
+void TilePlane::findLeftNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const{
+    walkLeft(*this, centre, [this, &neighbors](unsigned int n){ neighbors.push_back(mPool->getTile(n)); });
+}
+
+void TilePlane::findRightNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const{
+    walkRight(*this, centre, [this, &neighbors](unsigned int n){ neighbors.push_back(mPool->getTile(n)); });
+}
+
+bool TilePlane::boundingBox(const std::vector<unsigned int> &tiles, Cord &lowerLeft, Cord &upperRight) const{
+    if(tiles.empty()) return false;
+
+    len_t xl = mX[tiles[0]], yl = mY[tiles[0]];
+    len_t xh = xl + mW[tiles[0]], yh = yl + mH[tiles[0]];
+    for(unsigned int i : tiles){
+        if(mX[i] < xl) xl = mX[i];
+        if(mY[i] < yl) yl = mY[i];
+        if(mX[i] + mW[i] > xh) xh = mX[i] + mW[i];
+        if(mY[i] + mH[i] > yh) yh = mY[i] + mH[i];
+    }
+    lowerLeft = Cord(xl, yl);
+    upperRight = Cord(xh, yh);
+    return true;
+}
+
+area_t TilePlane::totalArea(tileType t) const{
+    unsigned char type = (unsigned char) t;
+    area_t area = 0;
+    for(unsigned int i = 0; i < mType.size(); ++i){
+        if((mType[i] & ~OWNER_FIXED_BIT) == type && mType[i] != TYPE_FREE){
+            area += (area_t) mW[i] * mH[i];
+        }
+    }
+    return area;
+}
+
+void TilePlane::collectTiles(tileType t, std::vector<unsigned int> &tiles) const{
+    unsigned char type = (unsigned char) t;
+    for(unsigned int i = 0; i < mType.size(); ++i){
+        if((mType[i] & ~OWNER_FIXED_BIT) == type && mType[i] != TYPE_FREE){
+            tiles.push_back(i);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef __TILEPLANE_H__
+#define __TILEPLANE_H__
+
+#include <vector>
+#include "LFUnits.h"
+#include "Tile.h"
+#include "TilePool.h"
+
+// Structure-of-arrays mirror of the corner-stitched plane held by a TilePool.
+// Slot i of every array describes the tile with pool handle i: geometry as len_t x/y/w/h, the four stitches as
+// handles and a compact type/owner pair. Walks over the mirror only touch the arrays they need, so neighbor finding,
+// point location and full-plane scans stream through contiguous memory instead of chasing ~100 byte Tiles.
+// The mirror is a snapshot: it is built from the pool in O(capacity) and must be rebuilt after any plane edit,
+// see LFLegaliser::syncTilePlane.
+class TilePlane{
+public:
+    static const unsigned int NULL_INDEX = Tile::NULL_HANDLE;
+    // mType value of slots that are not in use
+    static const unsigned char TYPE_FREE = 0xFF;
+    // set in mType if the owner of a BLOCK tile is a fixed Tessera
+    static const unsigned char OWNER_FIXED_BIT = 0x80;
+
+private:
+    const TilePool *mPool;
+    unsigned long long mVersion;
+    bool mBuilt;
+
+    std::vector <len_t> mX, mY, mW, mH;
+    std::vector <unsigned int> mRt, mTr, mBl, mLb;
+    std::vector <unsigned char> mType;
+    // index of the owning Tessera for BLOCK tiles, -1 otherwise
+    std::vector <int> mOwner;
+
+    unsigned int toIndex(const Tile *tile) const;
+
+public:
+    TilePlane();
+
+    // Rebuilds every array from "pool", tagging the result with the plane version of the caller
+    void build(const TilePool &pool, unsigned long long version);
+    void clear();
+    bool isCurrent(unsigned long long version) const;
+    unsigned int size() const;
+
+    Tile *getTile(unsigned int index) const;
+    bool isInUse(unsigned int index) const;
+    tileType getType(unsigned int index) const;
+    // owner of a BLOCK tile, -1 if none. "isFixed" tells which Tessera array the index refers to
+    int getOwner(unsigned int index, bool &isFixed) const;
+
+    inline len_t x(unsigned int index) const { return mX[index]; }
+    inline len_t y(unsigned int index) const { return mY[index]; }
+    inline len_t w(unsigned int index) const { return mW[index]; }
+    inline len_t h(unsigned int index) const { return mH[index]; }
+    inline unsigned int rt(unsigned int index) const { return mRt[index]; }
+    inline unsigned int tr(unsigned int index) const { return mTr[index]; }
+    inline unsigned int bl(unsigned int index) const { return mBl[index]; }
+    inline unsigned int lb(unsigned int index) const { return mLb[index]; }
+
+    // Same walk as LFLegaliser::findPoint, starting from tile "start"
+    unsigned int findPoint(const Cord &key, unsigned int start) const;
+
+    // Same order as the LFLegaliser::findXXXNeighbors walks
+    void findTopNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const;
+    void findDownNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const;
+    void findLeftNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const;
+    void findRightNeighbors(unsigned int centre, std::vector<unsigned int> &neighbors) const;
+    // Tile* flavours, used by the LFLegaliser adapter
+    void findTopNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const;
+    void findDownNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const;
+    void findLeftNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const;
+    void findRightNeighbors(unsigned int centre, std::vector<Tile *> &neighbors) const;
+
+    // Bounding box of a set of tiles, returns false if "tiles" is empty
+    bool boundingBox(const std::vector<unsigned int> &tiles, Cord &lowerLeft, Cord &upperRight) const;
+    // Total area of the tiles of type "t", linear scan over the mirror
+    area_t totalArea(tileType t) const;
+    // Appends every in-use tile of type "t", in handle order
+    void collectTiles(tileType t, std::vector<unsigned int> &tiles) const;
+};
+
+#endif // __TILEPLANE_H__
@@ -0,0 +1,164 @@
+#include <assert.h>
+#include "TilePool.h"
+
+TilePool::TilePool()
+    : mNextFresh(0), mLiveCount(0) {}
+
+Tile *TilePool::grab(){
+    Tile *tile;
+    if(!mFreeList.empty()){
+        tile = mFreeList.back();
+        mFreeList.pop_back();
+    }else{
+        if(mNextFresh == mSlabs.size() * SLAB_SIZE){
+            mSlabs.push_back(std::unique_ptr<Tile[]>(new Tile[SLAB_SIZE]));
+            mInUse.resize(mSlabs.size() * SLAB_SIZE, 0);
+            mGeneration.resize(mSlabs.size() * SLAB_SIZE, 0);
+        }
+        tile = slot(mNextFresh);
+        tile->mHandle = mNextFresh;
+        mNextFresh++;
+    }
+
+    assert(!mInUse[tile->mHandle]);
+    mInUse[tile->mHandle] = 1;
+    mLiveCount++;
+    return tile;
+}
+
+Tile *TilePool::slot(unsigned int handle) const{
+    return &(mSlabs[handle / SLAB_SIZE][handle % SLAB_SIZE]);
+}
+
+Tile *TilePool::allocate(tileType t, Cord LL, len_t w, len_t h){
+    Tile *tile = grab();
+    (*tile) = Tile(t, LL, w, h);
+    tile->visitStamp = 0;
+    return tile;
+}
+
+Tile *TilePool::allocate(const Tile &other){
+    Tile *tile = grab();
+    (*tile) = other;
+    tile->visitStamp = 0;
+    return tile;
+}
+
+void TilePool::release(Tile *tile){
+    assert(tile != nullptr);
+    assert(tile->mHandle < mNextFresh && getTile(tile->mHandle) == tile);
+    assert(mInUse[tile->mHandle]);
+
+    mInUse[tile->mHandle] = 0;
+    mGeneration[tile->mHandle]++;
+    mLiveCount--;
+    // drop stale stitches so dangling reads are easy to spot
+    tile->rt = tile->tr = tile->bl = tile->lb = nullptr;
+    mFreeList.push_back(tile);
+}
+
+void TilePool::releaseAll(){
+    mSlabs.clear();
+    mInUse.clear();
+    mGeneration.clear();
+    mFreeList.clear();
+    mNextFresh = 0;
+    mLiveCount = 0;
+}
+
+void TilePool::cloneFrom(const TilePool &other){
+    if(this == &other) return;
+    releaseAll();
+
+    for(int s = 0; s < other.mSlabs.size(); ++s){
+        mSlabs.push_back(std::unique_ptr<Tile[]>(new Tile[SLAB_SIZE]));
+    }
+    mInUse = other.mInUse;
+    mGeneration = other.mGeneration;
+    mNextFresh = other.mNextFresh;
+    mLiveCount = other.mLiveCount;
+
+    for(unsigned int h = 0; h < mNextFresh; ++h){
+        Tile *t = slot(h);
+        (*t) = (*other.slot(h));
+        t->mHandle = h;
+        t->visitStamp = 0;
+        t->rt = translate(t->rt);
+        t->tr = translate(t->tr);
+        t->bl = translate(t->bl);
+        t->lb = translate(t->lb);
+    }
+
+    mFreeList.reserve(other.mFreeList.size());
+    for(Tile *t : other.mFreeList){
+        mFreeList.push_back(slot(t->mHandle));
+    }
+}
+
+Tile *TilePool::translate(const Tile *foreign) const{
+    if(foreign == nullptr) return nullptr;
+    assert(foreign->mHandle < mNextFresh);
+    return slot(foreign->mHandle);
+}
+
+void TilePool::takeSnapshot(TilePoolSnapshot &snap) const{
+    snap.tiles.clear();
+    snap.tiles.reserve(mNextFresh);
+    for(unsigned int h = 0; h < mNextFresh; ++h){
+        snap.tiles.push_back(*slot(h));
+    }
+    snap.inUse.assign(mInUse.begin(), mInUse.begin() + mNextFresh);
+    snap.freeHandles.clear();
+    snap.freeHandles.reserve(mFreeList.size());
+    for(Tile *t : mFreeList){
+        snap.freeHandles.push_back(t->mHandle);
+    }
+}
+
+void TilePool::restoreSnapshot(const TilePoolSnapshot &snap){
+    unsigned int snapCapacity = snap.tiles.size();
+    // the pool only ever grows, so every slot of the snapshot still exists
+    assert(snapCapacity <= mNextFresh);
+
+    for(unsigned int h = 0; h < snapCapacity; ++h){
+        (*slot(h)) = snap.tiles[h];
+        mInUse[h] = snap.inUse[h];
+        mGeneration[h]++;
+    }
+    // slots carved after the snapshot go back to the fresh region
+    for(unsigned int h = snapCapacity; h < mNextFresh; ++h){
+        Tile *t = slot(h);
+        t->rt = t->tr = t->bl = t->lb = nullptr;
+        mInUse[h] = 0;
+        mGeneration[h]++;
+    }
+    mNextFresh = snapCapacity;
+
+    mFreeList.clear();
+    for(unsigned int h : snap.freeHandles){
+        mFreeList.push_back(slot(h));
+    }
+    mLiveCount = snapCapacity - snap.freeHandles.size();
+}
+
+Tile *TilePool::getTile(unsigned int handle) const{
+    assert(handle < mNextFresh);
+    return slot(handle);
+}
+
+bool TilePool::isInUse(unsigned int handle) const{
+    return (handle < mNextFresh) && mInUse[handle];
+}
+
+unsigned int TilePool::getGeneration(unsigned int handle) const{
+    assert(handle < mNextFresh);
+    return mGeneration[handle];
+}
+
+unsigned int TilePool::getCapacity() const{
+    return mNextFresh;
+}
+
+unsigned int TilePool::getLiveCount() const{
+    return mLiveCount;
+}
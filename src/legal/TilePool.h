@@ -0,0 +1,68 @@
+#ifndef __TILEPOOL_H__
+#define __TILEPOOL_H__
+
+#include <vector>
+#include <memory>
+#include "LFUnits.h"
+#include "Tile.h"
+
+// Full copy of the pool contents, see TilePool::takeSnapshot
+struct TilePoolSnapshot{
+    std::vector <Tile> tiles;
+    std::vector <unsigned char> inUse;
+    std::vector <unsigned int> freeHandles;
+};
+
+// Slab allocator for the Tiles of one corner-stitched plane.
+// Tiles are carved out of fixed size slabs so neighbouring tiles share cache lines, and freed tiles are recycled
+// through a LIFO free list. Every Tile handed out owns a stable handle (slab * SLAB_SIZE + offset) that stays valid
+// until the tile is released, Tiles never move in memory.
+class TilePool{
+private:
+    static const unsigned int SLAB_SIZE = 1024;
+
+    std::vector <std::unique_ptr<Tile[]>> mSlabs;
+    std::vector <unsigned char> mInUse;
+    // bumped every time a slot is released, lets holders of a Tile* detect that the slot was recycled
+    std::vector <unsigned int> mGeneration;
+    std::vector <Tile *> mFreeList;
+    unsigned int mNextFresh;
+    unsigned int mLiveCount;
+
+    Tile *grab();
+    Tile *slot(unsigned int handle) const;
+
+public:
+    TilePool();
+    TilePool(const TilePool &other) = delete;
+    TilePool& operator = (const TilePool &other) = delete;
+
+    // A fresh tile with the given geometry and no stitches, same as Tile(t, LL, w, h)
+    Tile *allocate(tileType t, Cord LL, len_t w, len_t h);
+    // A fresh tile copying geometry, stitches and overlap indices of "other", same as Tile(other)
+    Tile *allocate(const Tile &other);
+    void release(Tile *tile);
+    // Releases every tile at once, all handed out pointers become invalid
+    void releaseAll();
+
+    // Makes this pool an exact copy of "other": every tile keeps its handle, stitches are remapped by handle into
+    // this pool. O(capacity), any tile previously handed out by this pool becomes invalid
+    void cloneFrom(const TilePool &other);
+    // Redirects a Tile* of a pool cloned from (or snapshotted into) this one to the tile with the same handle here
+    Tile *translate(const Tile *foreign) const;
+
+    // Saves every slot in O(capacity). Stitches are stored as raw pointers, they stay meaningful because tiles never move
+    void takeSnapshot(TilePoolSnapshot &snap) const;
+    // Puts every slot back to its state at takeSnapshot(), pointers that were valid then are valid again.
+    // Tiles allocated after the snapshot are released, generations of all slots are bumped
+    void restoreSnapshot(const TilePoolSnapshot &snap);
+
+    // handle -> Tile, handles range over [0, getCapacity())
+    Tile *getTile(unsigned int handle) const;
+    bool isInUse(unsigned int handle) const;
+    unsigned int getGeneration(unsigned int handle) const;
+    unsigned int getCapacity() const;
+    unsigned int getLiveCount() const;
+};
+
+#endif // __TILEPOOL_H__
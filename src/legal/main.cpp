@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <ctime>
+#include <stdexcept>
 
 #include "LFUnits.h"
 #include "Tile.h"
@@ -20,6 +21,7 @@ int main(int argc, char *argv[]) {
     std::string outputDir = "./outputs";
     std::string configFilePath = "./configs/default.conf";
     bool verbose = false;
+    bool deleteSelfTest = false;
     
     // print current time and date
     const char* cyanText = "\u001b[36m";
@@ -33,11 +35,12 @@ int main(int argc, char *argv[]) {
     // "a": -a doesn't require argument
     // "a:": -a requires a argument
     // "a::" argument is optional for -a 
-    while((cmd_opt = getopt(argc, argv, ":hi:o:f:c:m:s:v")) != -1) {
+    while((cmd_opt = getopt(argc, argv, ":hi:o:f:c:m:s:vd")) != -1) {
         switch (cmd_opt) {
         case 'h':
-            std::cout << "Usage: " << argv[0] << " [-h] [-i <input file>] [-o <output directory>] [-f <floorplan name>] [-m <legalization mode 0-3>] [-c <custom .conf file>] [-v]\n";
+            std::cout << "Usage: " << argv[0] << " [-h] [-i <input file>] [-o <output directory>] [-f <floorplan name>] [-m <legalization mode 0-3>] [-c <custom .conf file>] [-v] [-d]\n";
             std::cout << "\tNote: If a custom config file (-c) is provided, then the -s option will be ignored.\n";
+            std::cout << "\t-d: instead of legalizing, delete every block tile of the initial plane one by one and check the plane after each deletion\n";
             return 0;
         case 'i':
             inputFilePath = optarg;
@@ -54,6 +57,9 @@ int main(int argc, char *argv[]) {
         case 'c':
             configFilePath = optarg;
             break;
+        case 'd':
+            deleteSelfTest = true;
+            break;
         case 'v':
             verbose = true;
         case '?':
@@ -130,43 +136,37 @@ int main(int argc, char *argv[]) {
     std::cout << "Painting All Tesserae to Canvas" << std::endl;
     legaliser->arrangeTesseraetoCanvas();
     
-    std::cout << "Start combinable tile search, ";
-    std::vector <std::pair<Tile *, Tile *>> detectMergeTile;
-    legaliser->detectCombinableBlanks(detectMergeTile);
-    std::cout << detectMergeTile.size() << " candidates found" << std::endl << std::endl;
-    for(std::pair<Tile *, Tile *> tp : detectMergeTile){
-        legaliser->visualiseAddMark(tp.first);
-        legaliser->visualiseAddMark(tp.second);
-    }
-
-    legaliser->visualiseRemoveAllmark();
-    while(!detectMergeTile.empty()){
-        std::cout << "Merging Pair: #" << detectMergeTile.size() << std::endl;
-        detectMergeTile[0].first->show(std::cout);
-        detectMergeTile[0].second->show(std::cout);
+    // blank tiles come out of arrangeTesseraetoCanvas already merged into maximal strips, no rescan needed
+    legaliser->outputTileFloorplan(outputDir + "/" + casename + "_init.txt", casename);
 
-        legaliser->combineVerticalMergeableBlanks(detectMergeTile[0].first, detectMergeTile[0].second);
-        detectMergeTile.clear();
-        legaliser->detectCombinableBlanks(detectMergeTile);
+    if (deleteSelfTest){
+        std::cout << "Deleting every tile of the plane ..." << std::flush;
+        bool planeOk = legaliser->deleteTileSelfTest(69);
+        std::cout << (planeOk ? "plane ok" : "FAILED") << std::endl;
+        return planeOk ? 0 : 1;
     }
 
-
-    legaliser->outputTileFloorplan(outputDir + "/" + casename + "_init.txt", casename);
-
     std::cout << std::endl << std::endl;
     DFSL::DFSLegalizer dfsl;
 
-    dfsl.initDFSLegalizer(legaliser);
-
     // SETTING configs:
     // dfsl.config.setConfigValue<bool>("ExactAreaMigration", true);
 
-    // read config file 
+    // read config file, before the graph is built since UseTilePlane and IncrementalGraph shape it
     bool confSuccess = dfsl.config.readConfigFile(configFilePath);
     if (!confSuccess){
         std::cerr << "Error opening configs\n";
         return 0;
     }
+    try {
+        dfsl.compileConfig();
+    }
+    catch (std::invalid_argument& e){
+        std::cerr << "Invalid configs\n";
+        return 0;
+    }
+
+    dfsl.initDFSLegalizer(legaliser);
 
     // set verbose
     if (verbose){